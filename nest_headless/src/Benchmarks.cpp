@@ -0,0 +1,1018 @@
+#include "Benchmarks.h"
+#include "AgentGrid.h"
+#include "Alpha.h"
+#include "ForceBuffer.h"
+#include "VertexLocator.h"
+#include "DepthPipeline.h"
+#include "DepthRecording.h"
+#include "DepthMask.h"
+#include "AudienceFrame.h"
+#include "OccupancyGrid.h"
+#include "ofxCv.h"
+#include "Runner.h"
+
+bool Benchmarks::run(std::string name, std::vector<std::string> args) {
+  if (name == "grid") {
+    agentGrid();
+  } else if (name == "closest") {
+    closestVertex();
+  } else if (name == "sync") {
+    meshSync();
+  } else if (name == "forces") {
+    forces();
+  } else if (name == "step") {
+    step();
+  } else if (name == "depth") {
+    depth(args);
+  } else if (name == "mask") {
+    depthMask();
+  } else if (name == "roi") {
+    depthRegions();
+  } else if (name == "track") {
+    tracking();
+  } else if (name == "occupancy") {
+    occupancy();
+  } else if (name == "background") {
+    background();
+  } else if (name == "fusion") {
+    fusion(args);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+double Benchmarks::time(std::function<void()> fn, int iterations) {
+  fn(); // Warm up.
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    fn();
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+}
+
+// Per frame work of setBehavior: visible agents for every person, then the
+// invisible targets for every agent.
+void Benchmarks::agentGrid() {
+  float width = 1600; float height = 900;
+  float audienceRadius = 104; float visibilityRadius = 75; // Show values.
+  std::vector<int> peopleCounts = { 1, 5, 10, 20, 40 };
+  std::vector<int> agentCounts = { 5, 10, 30, 100, 300, 1000 };
+
+  cout << "people, agents, loops (us), grid (us), speedup" << endl;
+  for (auto numPeople : peopleCounts) {
+    int crossover = -1;
+    for (auto numAgents : agentCounts) {
+      ofSeedRandom(numPeople * 1000 + numAgents);
+      std::vector<glm::vec2> centroids, people;
+      for (int i = 0; i < numAgents; i++) {
+        centroids.push_back(glm::vec2(ofRandom(width), ofRandom(height)));
+      }
+      for (int i = 0; i < numPeople; i++) {
+        people.push_back(glm::vec2(ofRandom(width), ofRandom(height)));
+      }
+      int iterations = std::max(20, 200000 / (numAgents * numPeople));
+      volatile size_t sink = 0; // Keeps the work from being optimized away.
+
+      // What Nest used to do.
+      auto loops = time([&]() {
+        for (auto p : people) {
+          std::vector<int> visible;
+          for (int a = 0; a < numAgents; a++) {
+            if (glm::distance(centroids[a], p) <= visibilityRadius + audienceRadius) {
+              visible.push_back(a);
+            }
+          }
+          sink += visible.size();
+        }
+        for (int a = 0; a < numAgents; a++) {
+          std::vector<glm::vec2> invisible;
+          for (auto p : people) {
+            if (glm::distance(centroids[a], p) > audienceRadius + visibilityRadius) {
+              invisible.push_back(p);
+            }
+          }
+          sink += invisible.size();
+        }
+      }, iterations);
+
+      // Grid, rebuilt every frame like in Nest.
+      AgentGrid grid;
+      grid.setup(width, height);
+      std::vector<int> visibleIdx;
+      std::vector<char> visibility;
+      std::vector<int> visibleCount;
+      auto gridTime = time([&]() {
+        grid.clear();
+        for (int a = 0; a < numAgents; a++) {
+          grid.add(a, centroids[a], visibilityRadius + audienceRadius);
+        }
+        grid.build();
+        visibility.assign(numAgents * numPeople, 0);
+        visibleCount.assign(numAgents, 0);
+        for (int p = 0; p < numPeople; p++) {
+          grid.getVisible(people[p], visibleIdx);
+          for (auto idx : visibleIdx) {
+            visibility[idx * numPeople + p] = 1;
+            visibleCount[idx]++;
+          }
+          sink += visibleIdx.size();
+        }
+        for (int a = 0; a < numAgents; a++) {
+          if (visibleCount[a] == 0) {
+            std::vector<glm::vec2> invisible = people;
+            sink += invisible.size();
+            continue;
+          }
+          std::vector<glm::vec2> invisible;
+          invisible.reserve(numPeople - visibleCount[a]);
+          for (int p = 0; p < numPeople; p++) {
+            if (!visibility[a * numPeople + p]) {
+              invisible.push_back(people[p]);
+            }
+          }
+          sink += invisible.size();
+        }
+      }, iterations);
+
+      if (crossover < 0 && gridTime < loops) {
+        crossover = numAgents;
+      }
+      cout << numPeople << ", " << numAgents << ", " << loops << ", " << gridTime << ", "
+           << loops / gridTime << endl;
+    }
+    cout << "Crossover at " << numPeople << " people: "
+         << (crossover < 0 ? "none" : ofToString(crossover) + " agents") << endl;
+  }
+}
+
+// Closest vertex of an agent to a point, every vertex vs the VertexLocator's boundary scan
+// and walk, on a resting, a dented and a folded mesh. The walk stops where no neighbor is
+// closer, so on a bent mesh it can miss the closest vertex: counts how often and by how much.
+void Benchmarks::closestVertex() {
+  float size = 50; // Show's alpha mesh size (px).
+  int numTargets = 2000;
+
+  cout << "mesh, shape, every vertex (us), locator (us), speedup, missed (%), max extra distance (px)" << endl;
+  for (int n : { 5, 20, 100 }) {
+    for (std::string shape : { "rest", "dented", "folded" }) {
+      ofSeedRandom(n);
+      // Same layout and joints as Alpha.
+      std::vector<glm::vec3> points(n * n);
+      for (int y = 0; y < n; y++) {
+        for (int x = 0; x < n; x++) {
+          float u = x / (n - 1.0f); float v = y / (n - 1.0f);
+          if (shape == "dented") {
+            v += 0.5f * (1 - v) * exp(-pow((u - 0.5f) / 0.15f, 2)); // Pushed in from the top.
+          } else if (shape == "folded") {
+            u = u > 0.5f ? 1.05f - u : u; v += u > 0.5f ? 0.02f : 0; // Right half over the left.
+          }
+          float jitter = size / n * 0.1f;
+          points[y * n + x] = glm::vec3(u * size + ofRandom(-jitter, jitter), v * size + ofRandom(-jitter, jitter), 0);
+        }
+      }
+      std::vector<int> boundary;
+      for (int x = 0; x < n; x++) boundary.push_back(x);
+      for (int y = 1; y < n; y++) boundary.push_back(y * n + n - 1);
+      for (int x = n - 2; x >= 0; x--) boundary.push_back((n - 1) * n + x);
+      for (int y = n - 2; y > 0; y--) boundary.push_back(y * n);
+      VertexLocator locator;
+      locator.setup(boundary, points.size());
+      for (int y = 0; y < n; y++) {
+        for (int x = 0; x < n; x++) {
+          if (x != n - 1) locator.addNeighbor(y * n + x, y * n + x + 1);
+          if (y != n - 1) locator.addNeighbor(y * n + x, (y + 1) * n + x);
+        }
+      }
+
+      // People and other agents around it, a few inside it.
+      std::vector<glm::vec2> targets;
+      auto center = glm::vec2(size / 2, size / 2);
+      for (int i = 0; i < numTargets; i++) {
+        float angle = ofRandom(TWO_PI); float radius = ofRandom(0, size * 1.5f);
+        targets.push_back(center + glm::vec2(cos(angle), sin(angle)) * radius);
+      }
+
+      auto getClosest = [&](glm::vec2 target) {
+        float minD = std::numeric_limits<float>::max(); int minIdx = -1;
+        for (int i = 0; i < points.size(); i++) {
+          auto diff = glm::vec2(points[i].x, points[i].y) - target;
+          auto d = glm::dot(diff, diff);
+          if (d < minD) {
+            minD = d; minIdx = i;
+          }
+        }
+        return minIdx;
+      };
+      int missed = 0; float maxExtra = 0;
+      for (auto t : targets) {
+        int exact = getClosest(t); int found = locator.getClosest(points, t);
+        if (found != exact) {
+          float extra = glm::distance(glm::vec2(points[found].x, points[found].y), t) -
+                        glm::distance(glm::vec2(points[exact].x, points[exact].y), t);
+          missed += extra > 0;
+          maxExtra = std::max(maxExtra, extra);
+        }
+      }
+
+      volatile int sink = 0;
+      auto every = time([&]() {
+        for (auto t : targets) {
+          sink += getClosest(t);
+        }
+      }, 10) / numTargets;
+      auto located = time([&]() {
+        for (auto t : targets) {
+          sink += locator.getClosest(points, t);
+        }
+      }, 10) / numTargets;
+
+      cout << n << "x" << n << ", " << shape << ", " << every << ", " << located << ", " << every / located << ", "
+           << 100.0f * missed / numTargets << ", " << maxExtra << endl;
+    }
+  }
+}
+
+void Benchmarks::meshSync() {
+  std::vector<int> gridSizes = { 5, 20, 100 };
+
+  cout << "grid, vertices, per vertex (us), bulk (us), speedup" << endl;
+  for (auto n : gridSizes) {
+    ofxBox2d box2d;
+    box2d.init();
+    box2d.setGravity(0, 0);
+
+    auto props = Runner::getShowAlphaProps(n, n);
+    props.meshSize = ofPoint(n * 10, n * 10); // Keep the vertices from overlapping.
+    props.meshOrigin = ofPoint(100, 100);
+    Alpha agent(box2d, props);
+    box2d.update(); // Move the bodies off their mesh positions.
+
+    auto &mesh = agent.getMesh();
+    int iterations = std::max(10, 200000 / (n * n));
+
+    // What Alpha::updateMesh used to do.
+    auto perVertex = time([&]() {
+      auto meshPoints = mesh.getVertices();
+      for (int j = 0; j < meshPoints.size(); j++) {
+        glm::vec2 pos = agent.vertices[j]->getPosition();
+        auto meshPoint = meshPoints[j];
+        meshPoint.x = pos.x;
+        meshPoint.y = pos.y;
+        mesh.setVertex(j, meshPoint);
+      }
+    }, iterations);
+
+    auto bulk = time([&]() {
+      agent.updateMesh();
+    }, iterations);
+
+    cout << n << "x" << n << ", " << n * n << ", " << perVertex << ", " << bulk << ", "
+         << perVertex / bulk << endl;
+
+    agent.clean(box2d);
+  }
+}
+
+void Benchmarks::forces() {
+  std::vector<int> gridSizes = { 5, 20, 100 };
+  float maxVelocity = 10; float stretchWeight = 0.2; float tickleWeight = 0.8;
+
+  cout << "grid, vertices, per vertex (us), buffer (us), speedup" << endl;
+  for (auto n : gridSizes) {
+    ofxBox2d box2d;
+    box2d.init();
+    box2d.setGravity(0, 0);
+
+    auto props = Runner::getShowAlphaProps(n, n);
+    props.meshSize = ofPoint(n * 10, n * 10);
+    props.meshOrigin = ofPoint(100, 100);
+    Alpha agent(box2d, props);
+    std::vector<b2Body *> bodies;
+    for (auto &v : agent.vertices) {
+      bodies.push_back(v->body);
+    }
+    auto centroid = agent.getCentroid();
+    int iterations = std::max(10, 200000 / (n * n));
+
+    // What the behaviors used to do.
+    auto perVertex = time([&]() {
+      for (auto &v : agent.vertices) {
+        if (v->getVelocity().length() > maxVelocity) {
+          auto vel = v->getVelocity().normalize() * maxVelocity;
+          v->setVelocity(vel.x, vel.y);
+        }
+      }
+      for (auto &v : agent.vertices) {
+        v->addRepulsionForce(centroid.x, centroid.y, stretchWeight);
+      }
+      for (auto &v : agent.vertices) {
+        v->addForce(glm::vec2(ofRandom(-2, 2), ofRandom(-2, 2)), tickleWeight);
+      }
+    }, iterations);
+
+    ForceBuffer buffer;
+    std::mt19937 rng;
+    auto batched = time([&]() {
+      buffer.load(bodies);
+      buffer.clampVelocity(maxVelocity);
+      buffer.addRepulsionAll(centroid, stretchWeight);
+      buffer.addJitter(2 * tickleWeight, rng);
+      buffer.apply(bodies);
+    }, iterations);
+
+    cout << n << "x" << n << ", " << n * n << ", " << perVertex << ", " << batched << ", "
+         << perVertex / batched << endl;
+
+    agent.clean(box2d);
+  }
+}
+
+// Box2d can only step a world on one thread, but inside the step every island (bodies
+// connected by touching contacts and joints) is solved on its own. This measures the
+// step and how much an island parallel solver could get out of it: islands are handed
+// out largest first to the least loaded thread, the busiest thread bounds the step.
+void Benchmarks::step() {
+  std::vector<int> agentCounts = { 10, 50, 200 };
+  std::vector<int> threadCounts = { 2, 4, 8 };
+  int warmUpFrames = 300; int steps = 60;
+
+  // Islands touching a static body (the bounds) share it, so a parallel solver would
+  // still solve those one after the other. The speedup counts them as serial.
+  cout << "agents, bodies, step (ms), islands, largest island, on the bounds (% of bodies), "
+       << "speedup on 2/4/8 threads" << endl;
+  for (auto numAgents : agentCounts) {
+    RunnerSettings settings;
+    settings.numAgents = numAgents;
+    settings.meshRows = 20; settings.meshColumns = 20;
+    settings.frames = warmUpFrames; // Let the audience bond them first.
+    Runner runner;
+    runner.setup(settings);
+    runner.run();
+
+    auto &box2d = runner.getNest().box2d;
+    auto stepTime = time([&]() {
+      box2d.update();
+    }, steps);
+
+    auto islands = getIslands(box2d.getWorld());
+    std::sort(islands.begin(), islands.end(), [](const Island &a, const Island &b) {
+      return a.size > b.size;
+    });
+    int bodies = 0; int serialBodies = 0;
+    for (auto &island : islands) {
+      bodies += island.size;
+      serialBodies += island.isOnStatic ? island.size : 0;
+    }
+
+    cout << numAgents << ", " << bodies << ", " << stepTime / 1000 << ", " << islands.size() << ", "
+         << (islands.empty() ? 0 : islands[0].size) << ", "
+         << (bodies > 0 ? 100.0f * serialBodies / bodies : 0);
+    for (auto numThreads : threadCounts) {
+      std::vector<int> loads(numThreads, 0);
+      for (auto &island : islands) {
+        if (!island.isOnStatic) {
+          *std::min_element(loads.begin(), loads.end()) += island.size;
+        }
+      }
+      int busiest = serialBodies + *std::max_element(loads.begin(), loads.end());
+      cout << ", " << (busiest > 0 ? (float) bodies / busiest : 0);
+    }
+    cout << endl;
+  }
+}
+
+std::vector<Benchmarks::Island> Benchmarks::getIslands(b2World *world) {
+  // Same walk as b2World::Solve: static bodies don't join islands.
+  std::vector<Island> islands;
+  std::unordered_set<b2Body *> visited;
+  std::vector<b2Body *> stack;
+  for (auto seed = world->GetBodyList(); seed; seed = seed->GetNext()) {
+    if (seed->GetType() == b2_staticBody || !seed->IsAwake() || !seed->IsActive() || visited.count(seed)) {
+      continue;
+    }
+
+    Island island { 0, false };
+    stack.push_back(seed);
+    visited.insert(seed);
+    while (!stack.empty()) {
+      auto body = stack.back();
+      stack.pop_back();
+      island.size++;
+
+      for (auto ce = body->GetContactList(); ce; ce = ce->next) {
+        auto contact = ce->contact;
+        if (!contact->IsEnabled() || !contact->IsTouching() ||
+            contact->GetFixtureA()->IsSensor() || contact->GetFixtureB()->IsSensor()) {
+          continue;
+        }
+        if (ce->other->GetType() == b2_staticBody) {
+          island.isOnStatic = true;
+        } else if (visited.insert(ce->other).second) {
+          stack.push_back(ce->other);
+        }
+      }
+
+      for (auto je = body->GetJointList(); je; je = je->next) {
+        if (!je->other->IsActive()) {
+          continue;
+        }
+        if (je->other->GetType() == b2_staticBody) {
+          island.isOnStatic = true;
+        } else if (visited.insert(je->other).second) {
+          stack.push_back(je->other);
+        }
+      }
+    }
+    islands.push_back(island);
+  }
+  return islands;
+}
+
+void Benchmarks::depth(std::vector<std::string> args) {
+  std::string path = args.size() > 0 ? args[0] : "Kinect.depth";
+  bool isRealtime = args.size() > 1 && args[1] == "realtime";
+  DepthReplay replay;
+  if (!replay.load(path)) {
+    return;
+  }
+  auto settings = getShowDepthSettings();
+  int numFrames = replay.getNumFrames();
+
+  std::vector<double> times; // Processing (ms)
+  std::vector<double> latencies; // Capture to read (ms)
+  int people = 0; int processed = 0;
+  auto addFrame = [&](const PeopleFrame &frame) {
+    times.push_back(frame.processingTime);
+    people += frame.blobs.size();
+    processed = frame.frameIdx + 1;
+  };
+
+  DepthFrame input;
+  auto start = std::chrono::high_resolution_clock::now();
+  if (isRealtime) {
+    DepthPipeline pipeline;
+    pipeline.setSettings(settings);
+    pipeline.start();
+    auto startTime = ofGetElapsedTimeMicros();
+    replay.getFrame(0, input);
+    auto firstTimestamp = input.timestamp;
+    for (int i = 0; i < numFrames; i++) {
+      replay.getFrame(i, input);
+      // Wait for the frame to be due.
+      auto due = startTime + (input.timestamp - firstTimestamp);
+      auto now = ofGetElapsedTimeMicros();
+      if (due > now) {
+        std::this_thread::sleep_for(std::chrono::microseconds(due - now));
+      }
+      input.timestamp = ofGetElapsedTimeMicros();
+      pipeline.push(input);
+
+      // What a render frame would have seen.
+      if (pipeline.update()) {
+        auto &frame = pipeline.getFrame();
+        addFrame(frame);
+        latencies.push_back((ofGetElapsedTimeMicros() - frame.timestamp) / 1000.0);
+      }
+    }
+    ofSleepMillis(100); // The last one.
+    if (pipeline.update()) {
+      addFrame(pipeline.getFrame());
+    }
+    pipeline.stop();
+  } else {
+    DepthProcessor processor;
+    PeopleFrame output;
+    for (int i = 0; i < numFrames; i++) {
+      replay.getFrame(i, input);
+      processor.process(input, settings, output);
+      addFrame(output);
+    }
+  }
+  double total = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+  auto percentile = [](std::vector<double> values, float p) {
+    if (values.empty()) {
+      return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    return values[(int) (p * (values.size() - 1))];
+  };
+  cout << "Frames: " << numFrames << " (" << replay.getWidth() << "x" << replay.getHeight() << "), processed: " << processed
+       << ", " << (isRealtime ? "realtime" : "as fast as possible") << " in " << total << " ms" << endl;
+  cout << "Processing (ms) p50: " << percentile(times, 0.5) << " p90: " << percentile(times, 0.9)
+       << " max: " << percentile(times, 1) << endl;
+  cout << "People per frame: " << (times.empty() ? 0 : (float) people / times.size()) << endl;
+  if (isRealtime) {
+    cout << "Capture to read (ms) p50: " << percentile(latencies, 0.5) << " p90: " << percentile(latencies, 0.9) << endl;
+  }
+}
+
+// bin/data/Kinect.xml
+DepthSettings Benchmarks::getShowDepthSettings() {
+  DepthSettings settings;
+  settings.minDistance = 1591.84;
+  settings.maxDistance = 5142.86;
+  settings.blur = 1.93878;
+  settings.imageThreshold = 0;
+  settings.erosion = 24;
+  settings.dilation = 21;
+  settings.minArea = 8.07143;
+  settings.maxArea = 100.291;
+  settings.contourThreshold = 217;
+  return settings;
+}
+
+void Benchmarks::depthMask() {
+  int width = 512; int height = 424; // Kinect V2 depth.
+  std::vector<ofPoint> morphology = { ofPoint(0, 0), ofPoint(3, 3), ofPoint(8, 6), ofPoint(24, 21) }; // Erode, dilate. Last is the show's.
+
+  // A far floor, a few people and sensor noise.
+  ofSeedRandom(11);
+  std::vector<glm::vec3> people;
+  for (int p = 0; p < 6; p++) {
+    people.push_back(glm::vec3(ofRandom(40, width - 40), ofRandom(40, height - 40), ofRandom(15, 35)));
+  }
+  ofShortPixels raw;
+  makeDepth(width, height, people, raw);
+
+  // What the Kinect gives (float mm), and what KinectSource rounds it to.
+  std::vector<float> rawFloat(raw.size());
+  for (size_t i = 0; i < raw.size(); i++) {
+    rawFloat[i] = raw[i] == 0 ? 0 : std::max(raw[i] + ofRandom(-0.5, 0.5), 0.0f);
+    raw[i] = ofClamp(rawFloat[i] + 0.5f, 0, 65535);
+  }
+
+  cout << "erode, dilate, ofxCv chain (us), fused (us), speedup, bit exact, "
+       << "off the float chain: depth px, max levels, mask px" << endl;
+  for (auto m : morphology) {
+    auto settings = getShowDepthSettings();
+    settings.erosion = m.x;
+    settings.dilation = m.y;
+    int iterations = 200;
+
+    // What DepthProcessor used to do.
+    ofPixels chainDepth, chainMask;
+    auto chain = time([&]() {
+      DepthProcessor::mapDepth(raw, settings.minDistance, settings.maxDistance, chainDepth);
+      chainMask = chainDepth;
+      ofxCv::blur(chainMask, chainMask, settings.blur);
+      ofxCv::erode(chainMask, chainMask, settings.erosion);
+      ofxCv::dilate(chainMask, chainMask, settings.dilation);
+      ofxCv::threshold(chainMask, chainMask, settings.imageThreshold);
+    }, iterations);
+
+    DepthMask kernel;
+    ofPixels depth, mask;
+    auto fused = time([&]() {
+      kernel.process(raw, settings, depth, mask);
+    }, iterations);
+
+    bool isExact = memcmp(chainMask.getData(), mask.getData(), mask.size()) == 0 &&
+                   memcmp(chainDepth.getData(), depth.getData(), depth.size()) == 0;
+
+    // The same chain on the Kinect's float depth, as ofxKinectV2 maps it to 8 bits.
+    ofPixels floatDepth, floatMask;
+    floatDepth.allocate(width, height, OF_PIXELS_GRAY);
+    for (size_t i = 0; i < rawFloat.size(); i++) {
+      floatDepth[i] = ofMap(rawFloat[i], settings.minDistance, settings.maxDistance, 255, 0, true);
+    }
+    floatMask = floatDepth;
+    ofxCv::blur(floatMask, floatMask, settings.blur);
+    ofxCv::erode(floatMask, floatMask, settings.erosion);
+    ofxCv::dilate(floatMask, floatMask, settings.dilation);
+    ofxCv::threshold(floatMask, floatMask, settings.imageThreshold);
+    int depthOff = 0; int maxLevels = 0; int maskOff = 0;
+    for (size_t i = 0; i < depth.size(); i++) {
+      int levels = std::abs(depth[i] - floatDepth[i]);
+      depthOff += levels > 0;
+      maxLevels = std::max(maxLevels, levels);
+      maskOff += mask[i] != floatMask[i];
+    }
+
+    cout << m.x << ", " << m.y << ", " << chain << ", " << fused << ", " << chain / fused << ", "
+         << (isExact ? "yes" : "NO") << ", " << depthOff << ", " << maxLevels << ", " << maskOff << endl;
+  }
+}
+
+void Benchmarks::depthRegions() {
+  int width = 512; int height = 424;
+  int numFrames = 300;
+
+  cout << "people, whole frame (us), pyramid + regions (us), speedup, region frames, coverage, same people" << endl;
+  for (int numPeople : { 1, 3, 10, 20 }) {
+    // People walking around the room, bouncing off its sides.
+    ofSeedRandom(numPeople);
+    std::vector<glm::vec3> people; std::vector<glm::vec2> velocities;
+    for (int p = 0; p < numPeople; p++) {
+      people.push_back(glm::vec3(ofRandom(40, width - 40), ofRandom(40, height - 40), ofRandom(28, 40)));
+      velocities.push_back(glm::vec2(ofRandom(-3, 3), ofRandom(-3, 3)));
+    }
+
+    auto fullSettings = getShowDepthSettings();
+    fullSettings.pyramidLevel = 0;
+    auto regionSettings = getShowDepthSettings();
+    DepthProcessor fullProcessor, regionProcessor;
+    PeopleFrame fullFrame, regionFrame;
+    DepthFrame input;
+    double fullTime = 0; double regionTime = 0; float coverage = 0;
+    int regionFrames = 0; int samePeople = 0;
+    for (int i = 0; i < numFrames; i++) {
+      for (int p = 0; p < numPeople; p++) {
+        auto &person = people[p]; auto &v = velocities[p];
+        if (person.x + v.x < 0 || person.x + v.x > width) {
+          v.x = -v.x;
+        }
+        if (person.y + v.y < 0 || person.y + v.y > height) {
+          v.y = -v.y;
+        }
+        person.x += v.x; person.y += v.y;
+      }
+      makeDepth(width, height, people, input.depth);
+
+      fullProcessor.process(input, fullSettings, fullFrame);
+      regionProcessor.process(input, regionSettings, regionFrame);
+      fullTime += fullFrame.processingTime;
+      regionTime += regionFrame.processingTime;
+      if (!regionFrame.isFullScan) {
+        regionFrames++;
+        coverage += regionFrame.coverage;
+      }
+
+      bool isSame = fullFrame.blobs.size() == regionFrame.blobs.size();
+      for (int b = 0; isSame && b < fullFrame.blobs.size(); b++) {
+        isSame = fullFrame.blobs[b].centroid == regionFrame.blobs[b].centroid;
+      }
+      samePeople += isSame;
+    }
+    fullTime *= 1000.0 / numFrames; regionTime *= 1000.0 / numFrames; // us
+    cout << numPeople << ", " << fullTime << ", " << regionTime << ", " << fullTime / regionTime << ", "
+         << regionFrames << "/" << numFrames << ", " << (regionFrames ? coverage / regionFrames : 1) << ", "
+         << samePeople << "/" << numFrames << endl;
+  }
+}
+
+void Benchmarks::tracking() {
+  int width = 512; int height = 424;
+  int numFrames = 300; int numPeople = 4;
+  uint64_t frameTime = 33333; // us, 30 Hz like the Kinect.
+
+  // People walking across the room at different speeds, turning around at its sides.
+  ofSeedRandom(5);
+  std::vector<glm::vec3> people; std::vector<glm::vec2> velocities; // px/s
+  for (int p = 0; p < numPeople; p++) {
+    people.push_back(glm::vec3(ofRandom(60, width - 60), ofRandom(60, height - 60), 35));
+    velocities.push_back(glm::vec2(ofRandom(-150, 150), ofRandom(-100, 100)));
+  }
+
+  DepthProcessor processor;
+  PeopleFrame frame;
+  DepthFrame input;
+  std::vector<int> leads = { 16, 33, 66, 100 }; // ms from capture to the nest using it.
+  std::vector<double> rawErrors(leads.size()), predictedErrors(leads.size());
+  int samples = 0;
+  for (int i = 0; i < numFrames; i++) {
+    float dt = frameTime / 1000000.0;
+    for (int p = 0; p < numPeople; p++) {
+      auto &person = people[p]; auto &v = velocities[p];
+      if (person.x + v.x * dt < 40 || person.x + v.x * dt > width - 40) {
+        v.x = -v.x;
+      }
+      if (person.y + v.y * dt < 40 || person.y + v.y * dt > height - 40) {
+        v.y = -v.y;
+      }
+      person.x += v.x * dt; person.y += v.y * dt;
+    }
+    makeDepth(width, height, people, input.depth);
+    input.timestamp = i * frameTime;
+    processor.process(input, getShowDepthSettings(), frame);
+
+    // Against where everybody really is by then, for whoever's nearest each blob.
+    for (auto &blob : frame.blobs) {
+      if (blob.age < 3) {
+        continue; // Not moving yet as far as the tracker knows.
+      }
+      int nearest = 0;
+      for (int p = 1; p < numPeople; p++) {
+        if (glm::distance(blob.centroid, glm::vec2(people[p])) < glm::distance(blob.centroid, glm::vec2(people[nearest]))) {
+          nearest = p;
+        }
+      }
+      for (int l = 0; l < leads.size(); l++) {
+        float lead = leads[l] / 1000.0;
+        auto truth = glm::vec2(people[nearest]) + velocities[nearest] * lead;
+        rawErrors[l] += glm::distance(blob.centroid, truth);
+        predictedErrors[l] += glm::distance(AudienceTracker::predict(blob, frame.timestamp, frame.timestamp + leads[l] * 1000, 100000), truth);
+      }
+      samples++;
+    }
+  }
+
+  cout << "lead (ms), last frame error (px), predicted error (px)" << endl;
+  for (int l = 0; l < leads.size(); l++) {
+    cout << leads[l] << ", " << rawErrors[l] / samples << ", " << predictedErrors[l] / samples << endl;
+  }
+}
+
+void Benchmarks::occupancy() {
+  float width = 1600; float height = 900;
+  int numAgents = 200; float visibilityRadius = 40; float audienceRadius = 100; // Agent, audience.
+  ofSeedRandom(3);
+  std::vector<glm::vec2> agents;
+  for (int i = 0; i < numAgents; i++) {
+    agents.push_back(glm::vec2(ofRandom(width), ofRandom(height)));
+  }
+
+  cout << "people, distance tests (us), rasterize (us), box lookups (us), touched by distance, touched by silhouette" << endl;
+  for (int numPeople : { 1, 10, 50 }) {
+    // Silhouettes of 64 points around every person.
+    std::vector<glm::vec2> people;
+    std::vector<std::vector<glm::vec2>> contours(numPeople);
+    for (int p = 0; p < numPeople; p++) {
+      people.push_back(glm::vec2(ofRandom(width), ofRandom(height)));
+      for (int i = 0; i < 64; i++) {
+        float angle = i * TWO_PI / 64;
+        float r = ofRandom(40, 80);
+        contours[p].push_back(people[p] + glm::vec2(cos(angle), sin(angle)) * r);
+      }
+    }
+
+    // What setBehavior does without the grid: every person against every agent.
+    std::vector<char> touched(numAgents);
+    auto distances = time([&]() {
+      for (int a = 0; a < numAgents; a++) {
+        touched[a] = 0;
+        for (auto &p : people) {
+          touched[a] |= glm::distance(p, agents[a]) < visibilityRadius + audienceRadius;
+        }
+      }
+    }, 1000);
+    int byDistance = std::count(touched.begin(), touched.end(), 1);
+
+    OccupancyGrid grid;
+    auto rasterize = time([&]() {
+      grid.setup(width, height, 20);
+      for (auto &contour : contours) {
+        grid.addPolygon(contour);
+      }
+      grid.build();
+    }, 1000);
+    auto lookups = time([&]() {
+      for (int a = 0; a < numAgents; a++) {
+        auto c = agents[a];
+        touched[a] = grid.isOccupied(ofRectangle(c.x - visibilityRadius, c.y - visibilityRadius, 2 * visibilityRadius, 2 * visibilityRadius));
+      }
+    }, 1000);
+    int bySilhouette = std::count(touched.begin(), touched.end(), 1);
+
+    cout << numPeople << ", " << distances << ", " << rasterize << ", " << lookups << ", "
+         << byDistance << ", " << bySilhouette << endl;
+  }
+}
+
+void Benchmarks::background() {
+  int width = 512; int height = 424;
+  int numFrames = 200; int numPeople = 4;
+  // In the middle of the room, a meter behind the people in front of it and in range.
+  glm::vec3 sculpture(width / 2, height / 2, 70);
+  auto addSculpture = [&](ofShortPixels &raw) {
+    auto data = raw.getData();
+    for (int y = sculpture.y - sculpture.z; y < sculpture.y + sculpture.z; y++) {
+      for (int x = sculpture.x - sculpture.z; x < sculpture.x + sculpture.z; x++) {
+        auto &d = data[y * width + x];
+        if (ofDist(x, y, sculpture.x, sculpture.y) < sculpture.z && d > 3000) {
+          d = 3500 + ofRandom(-50, 50);
+        }
+      }
+    }
+  };
+
+  // Show settings (range and heavy morphology) vs the learned background with a light touch.
+  std::vector<std::pair<std::string, DepthSettings>> variants;
+  variants.push_back({ "range, erode 24 dilate 21", getShowDepthSettings() });
+  for (int morphology : { 24, 3 }) {
+    auto settings = getShowDepthSettings();
+    settings.background = true;
+    settings.erosion = morphology; settings.dilation = morphology == 24 ? 21 : morphology;
+    variants.push_back({ "background, erode " + ofToString(settings.erosion) + " dilate " + ofToString(settings.dilation), settings });
+  }
+  for (auto &v : variants) {
+    v.second.pyramidLevel = 0; // Whole frames, so every variant does the same work every frame.
+  }
+
+  cout << "variant, processing (us), people found off by (avg), frames all found" << endl;
+  for (auto &variant : variants) {
+    ofSeedRandom(11); // The same noise.
+
+    // The same people every variant, in lanes so they never touch each other, two of
+    // them crossing in front of the sculpture.
+    std::vector<glm::vec3> people; std::vector<glm::vec2> velocities;
+    for (int p = 0; p < numPeople; p++) {
+      people.push_back(glm::vec3(40 + p * 100, 60 + p * 100, 30));
+      velocities.push_back(glm::vec2(2 + p, 0));
+    }
+
+    DepthProcessor processor;
+    PeopleFrame frame;
+    DepthFrame input;
+    // A second of the empty room first, to learn.
+    for (int i = 0; i < 30; i++) {
+      makeDepth(width, height, {}, input.depth);
+      addSculpture(input.depth);
+      processor.process(input, variant.second, frame);
+    }
+
+    double time = 0; double offBy = 0; int allFound = 0;
+    for (int i = 0; i < numFrames; i++) {
+      for (int p = 0; p < numPeople; p++) {
+        auto &person = people[p]; auto &v = velocities[p];
+        if (person.x + v.x < 40 || person.x + v.x > width - 40) {
+          v.x = -v.x;
+        }
+        person.x += v.x;
+      }
+      makeDepth(width, height, people, input.depth);
+      addSculpture(input.depth);
+
+      processor.process(input, variant.second, frame);
+      time += frame.processingTime;
+      offBy += std::abs((int) frame.blobs.size() - numPeople);
+      allFound += frame.blobs.size() == numPeople;
+    }
+    cout << variant.first << ", " << time * 1000 / numFrames << ", " << offBy / numFrames << ", "
+         << allFound << "/" << numFrames << endl;
+  }
+}
+
+void Benchmarks::fusion(std::vector<std::string> args) {
+  int width = 512; int height = 424;
+  int numFrames = 60; int numPeople = 8;
+  uint64_t frameTime = 33333; // us, 30 Hz like the Kinect.
+  uint64_t readTime = 16667; // us, 60 Hz render frames.
+  uint64_t duration = 5000000; // us
+  float overlap = 64; // px, the sensors stand side by side and see this much of each other's room.
+  float mergeDistance = 20;
+
+  // Every sensor's frames, looped. Recordings if there are any, else people walking across
+  // a room three sensors wide, each seeing its part of it.
+  std::vector<std::vector<DepthFrame>> frames;
+  for (auto &path : args) {
+    DepthReplay replay;
+    if (replay.load(path)) {
+      frames.emplace_back(std::min(numFrames, replay.getNumFrames()));
+      for (int i = 0; i < frames.back().size(); i++) {
+        replay.getFrame(i, frames.back()[i]);
+      }
+    }
+  }
+  bool isSynthetic = frames.empty();
+  if (isSynthetic) {
+    int numSources = 3;
+    ofSeedRandom(7);
+    float roomWidth = numSources * (width - overlap) + overlap;
+    std::vector<glm::vec3> people; std::vector<glm::vec2> velocities; // px/frame
+    for (int p = 0; p < numPeople; p++) {
+      people.push_back(glm::vec3(ofRandom(40, roomWidth - 40), ofRandom(40, height - 40), ofRandom(28, 40)));
+      velocities.push_back(glm::vec2(ofRandom(-3, 3), ofRandom(-3, 3)));
+    }
+    frames.resize(numSources, std::vector<DepthFrame>(numFrames));
+    std::vector<glm::vec3> seen;
+    for (int i = 0; i < numFrames; i++) {
+      for (int p = 0; p < numPeople; p++) {
+        auto &person = people[p]; auto &v = velocities[p];
+        if (person.x + v.x < 0 || person.x + v.x > roomWidth) {
+          v.x = -v.x;
+        }
+        if (person.y + v.y < 0 || person.y + v.y > height) {
+          v.y = -v.y;
+        }
+        person.x += v.x; person.y += v.y;
+      }
+      for (int s = 0; s < numSources; s++) {
+        seen = people;
+        for (auto &p : seen) {
+          p.x -= s * (width - overlap);
+        }
+        makeDepth(width, height, seen, frames[s][i].depth);
+      }
+    }
+  }
+  int numSources = frames.size();
+
+  // One pipeline thread per sensor, like the app's KinectSources.
+  std::vector<std::unique_ptr<DepthPipeline>> pipelines;
+  for (int s = 0; s < numSources; s++) {
+    pipelines.push_back(std::make_unique<DepthPipeline>());
+    pipelines.back()->setSettings(getShowDepthSettings());
+    pipelines.back()->start();
+  }
+
+  // The sensors aren't in sync, their frames come in a third of a frame apart. Render
+  // frames read whatever the pipelines have and merge it.
+  AudienceFrame audience;
+  std::vector<double> latencies; // Capture of the oldest frame behind the audience to read (ms)
+  std::vector<double> mergeTimes; // us
+  std::vector<double> processingTimes; // Depth frame to people, every source's own thread (ms)
+  std::vector<int> nextFrame(numSources, 0);
+  DepthFrame input;
+  uint64_t points = 0; uint64_t merged = 0;
+  auto startTime = ofGetElapsedTimeMicros();
+  uint64_t nextRead = 0;
+  while (true) {
+    // Next thing due: a sensor frame or a render frame.
+    uint64_t next = nextRead;
+    for (int s = 0; s < numSources; s++) {
+      next = std::min(next, nextFrame[s] * frameTime + s * frameTime / numSources);
+    }
+    if (next >= duration) {
+      break;
+    }
+    auto now = ofGetElapsedTimeMicros() - startTime;
+    if (next > now) {
+      std::this_thread::sleep_for(std::chrono::microseconds(next - now));
+    }
+
+    for (int s = 0; s < numSources; s++) {
+      if (nextFrame[s] * frameTime + s * frameTime / numSources <= next) {
+        // The pipeline swaps the buffer, so it gets a copy like the app's converted frame.
+        input = frames[s][nextFrame[s] % frames[s].size()];
+        input.timestamp = ofGetElapsedTimeMicros();
+        pipelines[s]->push(input);
+        nextFrame[s]++;
+      }
+    }
+    if (nextRead > next) {
+      continue;
+    }
+    nextRead += readTime;
+
+    auto readStart = ofGetElapsedTimeMicros();
+    audience.time = readStart;
+    audience.timestamp = readStart;
+    audience.points.clear(); audience.ids.clear(); audience.sources.clear();
+    bool hasFrames = true;
+    for (int s = 0; s < numSources; s++) {
+      bool isNew = pipelines[s]->update();
+      auto &frame = pipelines[s]->getFrame();
+      if (isNew) {
+        processingTimes.push_back(frame.processingTime);
+      }
+      hasFrames = hasFrames && frame.timestamp > 0;
+      audience.timestamp = std::min(audience.timestamp, frame.timestamp);
+      for (auto &blob : frame.blobs) {
+        audience.points.push_back(blob.centroid + glm::vec2(s * (width - overlap), 0));
+        audience.ids.push_back(s << 24 | blob.label);
+        audience.sources.push_back(s);
+      }
+    }
+    points += audience.points.size();
+    audience.mergeDuplicates(isSynthetic ? mergeDistance : 0);
+    merged += audience.points.size();
+    mergeTimes.push_back(ofGetElapsedTimeMicros() - readStart);
+    if (hasFrames) {
+      latencies.push_back(audience.getAge());
+    }
+  }
+  for (auto &pipeline : pipelines) {
+    pipeline->stop();
+  }
+
+  auto percentile = [](std::vector<double> values, float p) {
+    if (values.empty()) {
+      return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    return values[(int) (p * (values.size() - 1))];
+  };
+  int reads = mergeTimes.size();
+  cout << "Sources: " << numSources << (isSynthetic ? " synthetic" : " recorded") << ", render frames: " << reads << endl;
+  cout << "Processing (ms) p50: " << percentile(processingTimes, 0.5) << " p90: " << percentile(processingTimes, 0.9)
+       << " max: " << percentile(processingTimes, 1) << endl;
+  cout << "Capture of the oldest frame to merged (ms) p50: " << percentile(latencies, 0.5) << " p90: " << percentile(latencies, 0.9)
+       << " max: " << percentile(latencies, 1) << endl;
+  cout << "Read + merge (us) p50: " << percentile(mergeTimes, 0.5) << " p90: " << percentile(mergeTimes, 0.9)
+       << " of a " << readTime / 1000.0 << " ms render frame" << endl;
+  cout << "People per frame: " << (reads ? (float) points / reads : 0) << " seen, " << (reads ? (float) merged / reads : 0)
+       << " merged" << (isSynthetic ? ", " + ofToString(numPeople) + " in the room" : "") << endl;
+}
+
+void Benchmarks::makeDepth(int width, int height, const std::vector<glm::vec3> &people, ofShortPixels &raw) {
+  if (raw.getWidth() != width || raw.getHeight() != height) {
+    raw.allocate(width, height, OF_PIXELS_GRAY);
+  }
+  auto data = raw.getData();
+  for (int i = 0; i < width * height; i++) {
+    data[i] = ofRandom(1) < 0.05 ? ofRandom(0, 6000) : 5600 + ofRandom(-50, 50);
+  }
+  for (auto &p : people) {
+    int cx = p.x; int cy = p.y; int r = p.z;
+    for (int y = std::max(0, cy - r); y < std::min(height, cy + r); y++) {
+      for (int x = std::max(0, cx - r); x < std::min(width, cx + r); x++) {
+        if (ofDist(x, y, cx, cy) < r) {
+          data[y * width + x] = 2500 + ofRandom(-100, 100);
+        }
+      }
+    }
+  }
+}
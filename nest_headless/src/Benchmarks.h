@@ -0,0 +1,76 @@
+// Micro benchmarks for the simulation core. Run with: nest_headless --bench <name>
+#pragma once
+#include "ofMain.h"
+#include "ofxBox2d.h"
+#include "DepthProcessor.h"
+
+class Benchmarks {
+  public:
+    // Runs the benchmark with this name. Returns false if there is no such benchmark.
+    static bool run(std::string name, std::vector<std::string> args);
+
+    // Audience visibility: brute force loops vs the agent grid.
+    static void agentGrid();
+
+    // Closest vertex to a point: every vertex vs the VertexLocator, at 5x5, 20x20 and
+    // 100x100 on a resting, dented and folded mesh, with how often the locator misses.
+    static void closestVertex();
+
+    // Box2d to mesh sync: per vertex copy/setVertex vs the bulk sync, at 5x5, 20x20 and 100x100.
+    static void meshSync();
+
+    // Velocity clamp + stretch + tickle on every vertex: shape calls vs the force buffer.
+    static void forces();
+
+    // Box2d step at 10, 50 and 200 agents of 20x20, with the islands the solver splits
+    // the world into and how well they would spread over a few threads, with the ones
+    // on the bounds solved one after the other.
+    static void step();
+
+    // Depth pipeline on a recording (args: [file] [realtime]), with the show's Kinect.xml
+    // settings. As fast as possible through the processor, or paced like it was recorded
+    // through the pipeline thread.
+    static void depth(std::vector<std::string> args);
+    static DepthSettings getShowDepthSettings();
+
+    // Depth to mask: range map + ofxCv blur/erode/dilate/threshold vs the fused DepthMask,
+    // on synthetic 512x424 frames at a few morphology sizes. Checks they're bit exact, and
+    // how far both are off the chain on the float depth KinectSource rounds to mm.
+    static void depthMask();
+
+    // Whole frame vs pyramid level + full resolution regions, with 1, 3, 10 and 20 people
+    // walking around synthetic 512x424 frames. Checks both find the same people.
+    static void depthRegions();
+
+    // Where 4 synthetic people walking at up to 150 px/s are 16 to 100 ms after their
+    // depth frame: the last frame's centroids vs the AudienceTracker prediction.
+    static void tracking();
+
+    // Which of 200 agents are touched by 1, 10 and 50 people: distance tests against
+    // every person vs rasterizing their silhouettes and one box lookup per agent.
+    static void occupancy();
+
+    // 6 synthetic people walking around a sculpture in the middle of the room: the show's
+    // range and heavy morphology vs the learned background with heavy and light morphology.
+    // Processing time and how many people each finds.
+    static void background();
+
+    // One depth pipeline per sensor (args: recordings, else 3 synthetic sensors side by
+    // side), pushed at 30 Hz out of step and read and merged at 60 Hz. How old the merged
+    // audience is and how many people are seen twice where the sensors overlap.
+    static void fusion(std::vector<std::string> args);
+
+  private:
+    // The islands b2World::Solve would build right now.
+    struct Island {
+      int size; // Bodies.
+      bool isOnStatic; // Touches or is jointed to a static body.
+    };
+    static std::vector<Island> getIslands(b2World *world);
+
+    // A far floor with sensor noise and people (x, y, radius) standing closer.
+    static void makeDepth(int width, int height, const std::vector<glm::vec3> &people, ofShortPixels &raw);
+
+    // Average time of one call to the function in microseconds.
+    static double time(std::function<void()> fn, int iterations);
+};
@@ -0,0 +1,128 @@
+#include "Runner.h"
+
+void Runner::setup(RunnerSettings s) {
+  settings = s;
+  ofSeedRandom(settings.seed);
+
+  nest.setup(settings.width, settings.height);
+  setShowProps();
+  nest.createAgents(settings.numAgents);
+
+  frameTimes.clear();
+  frameTimes.reserve(settings.frames);
+  totalTime = 0;
+}
+
+void Runner::run() {
+  for (int frame = 0; frame < settings.frames; frame++) {
+    auto people = getPeople(frame);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    nest.update(people, 1.0 / settings.renderHz);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    frameTimes.push_back(ms);
+    totalTime += ms;
+  }
+}
+
+void Runner::report() {
+  auto sorted = frameTimes;
+  std::sort(sorted.begin(), sorted.end());
+
+  cout << "Frames: " << frameTimes.size() << ", Agents: " << nest.agents.size()
+       << ", Bonds: " << nest.bonds.size() << ", Nests: " << nest.graph.getClusters().size()
+       << " (largest " << nest.graph.getLargestNestSize() << ")" << endl;
+  cout << "Steps/sec: " << (totalTime > 0 ? frameTimes.size() * 1000.0 / totalTime : 0) << endl;
+  cout << "Frame time (ms) p50: " << getPercentile(sorted, 0.5)
+       << " p90: " << getPercentile(sorted, 0.9)
+       << " p99: " << getPercentile(sorted, 0.99)
+       << " max: " << (sorted.empty() ? 0 : sorted.back()) << endl;
+  cout << "Phases (smoothed):" << endl << nest.profiler.toString();
+
+  // Same seed, same result, whatever the number of threads.
+  glm::vec2 checksum(0, 0);
+  for (auto a : nest.agents) {
+    checksum += a->getCentroid();
+  }
+  cout << "Checksum: " << ofToString(checksum.x, 3) << ", " << ofToString(checksum.y, 3) << endl;
+}
+
+std::vector<glm::vec2> Runner::getPeople(int frame) {
+  std::vector<glm::vec2> people;
+
+  // Everybody leaves at the end of every cycle.
+  if (frame % settings.presenceCycle >= settings.presenceCycle - settings.absentFrames) {
+    return people;
+  }
+
+  // Slow lissajous walks across the floor, one per person.
+  auto center = glm::vec2(settings.width/2, settings.height/2);
+  for (int i = 0; i < settings.numPeople; i++) {
+    float t = frame * 0.004f * (1 + i * 0.25f);
+    float x = center.x + cos(t + i) * settings.width * 0.4f;
+    float y = center.y + sin(t * 1.3f + i * 2) * settings.height * 0.4f;
+    people.push_back(glm::vec2(x, y));
+  }
+
+  return people;
+}
+
+double Runner::getPercentile(std::vector<double> sorted, float p) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  int idx = ofClamp(p * (sorted.size() - 1), 0, sorted.size() - 1);
+  return sorted[idx];
+}
+
+void Runner::setShowProps() {
+  nest.alphaAgentProps = getShowAlphaProps(settings.meshRows, settings.meshColumns);
+  nest.betaAgentProps = getShowBetaProps();
+
+  auto &props = nest.props;
+  props.audienceVisibilityRadius = 104.337;
+  props.maxAgentsInWorld = 30;
+  props.reincarnationWaitTime = 40000;
+  props.jointPhysics = ofPoint(0.5, 1);
+  props.jointLength = ofPoint(500, 800);
+  props.physicsHz = settings.physicsHz;
+  props.maxSubSteps = 4;
+  props.behaviorThreads = settings.threads;
+}
+
+AlphaAgentProperties Runner::getShowAlphaProps(int meshRows, int meshColumns) {
+  AlphaAgentProperties alpha;
+  alpha.meshSize = ofPoint(50, 50);
+  alpha.meshRowsColumns = ofPoint(meshRows, meshColumns);
+  alpha.textureSize = ofPoint(300, 300);
+  alpha.vertexPhysics = ofPoint(0.1, 0.986607, 0.964286); // bounce, density, friction
+  alpha.vertexRadius = 4;
+  alpha.jointPhysics = ofPoint(0.7, 1); // frequency, damping
+  alpha.stretchWeight = 0.2;
+  alpha.repulsionWeight = 3;
+  alpha.attractionWeight = 3;
+  alpha.tickleWeight = 0.8;
+  alpha.velocity = 10;
+  alpha.visibilityRadiusFactor = 3;
+  return alpha;
+}
+
+BetaAgentProperties Runner::getShowBetaProps() {
+  BetaAgentProperties beta;
+  beta.meshRadius = 60;
+  beta.textureSize = ofPoint(100, 100);
+  beta.vertexPhysics = ofPoint(0.1, 1, 0.999872);
+  beta.vertexRadius = 3;
+  beta.centerJointPhysics = ofPoint(0.8, 0);
+  beta.sideJointPhysics = ofPoint(0.5, 0);
+  beta.sideJointOffset = 5;
+  beta.stretchWeight = 1;
+  beta.repulsionWeight = 2.95408;
+  beta.attractionWeight = 5;
+  beta.tickleWeight = 0.3;
+  beta.velocity = 10;
+  beta.visibilityRadiusFactor = 1.38776;
+  return beta;
+}
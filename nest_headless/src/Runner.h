@@ -0,0 +1,47 @@
+// Runner steps the Nest for a fixed number of frames with a scripted audience
+// and reports how fast the simulation core runs on a machine without a GPU.
+#pragma once
+#include "ofMain.h"
+#include "Nest.h"
+
+struct RunnerSettings {
+  int frames = 3600;
+  int numAgents = 30;
+  int numPeople = 4;
+  int meshRows = 7;
+  int meshColumns = 7;
+  int seed = 7;
+  float physicsHz = 60;
+  float renderHz = 60; // Every frame advances the nest by 1/renderHz.
+  int threads = 0; // Behavior threads, 0: one per core.
+  float width = 1600;
+  float height = 900;
+  // Audience leaves the room for this many frames out of every cycle, so the
+  // bonds also go through their break and memory phases.
+  int presenceCycle = 900;
+  int absentFrames = 300;
+};
+
+class Runner {
+  public:
+    void setup(RunnerSettings settings);
+    void run();
+    void report();
+
+    // Scripted audience position for every person at a frame.
+    std::vector<glm::vec2> getPeople(int frame);
+    Nest &getNest() { return nest; }
+
+    // Props the installation runs with (bin/data/InterMesh.xml).
+    static AlphaAgentProperties getShowAlphaProps(int meshRows, int meshColumns);
+    static BetaAgentProperties getShowBetaProps();
+
+  private:
+    void setShowProps();
+    double getPercentile(std::vector<double> sorted, float p);
+
+    RunnerSettings settings;
+    Nest nest;
+    std::vector<double> frameTimes; // ms
+    double totalTime; // ms
+};
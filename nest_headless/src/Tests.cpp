@@ -0,0 +1,57 @@
+#include "Tests.h"
+#include "WorkerPool.h"
+
+bool Tests::run(std::string name) {
+  if (name == "workers") {
+    return workerPool();
+  }
+  cout << "ERROR: Unknown test " << name << endl;
+  return false;
+}
+
+bool Tests::workerPool() {
+  int rounds = 2000; int count = 64;
+  std::vector<int> threadCounts = { 2, 3, 4, 8 };
+
+  // A hung parallelFor can't be interrupted, so a watchdog ends the process instead.
+  std::atomic<bool> isDone { false };
+  std::thread watchdog([&] {
+    auto start = std::chrono::steady_clock::now();
+    while (!isDone) {
+      if (std::chrono::steady_clock::now() - start > std::chrono::seconds(30)) {
+        cout << "FAIL workers: parallelFor hung" << endl;
+        std::_Exit(1);
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  });
+
+  bool isOk = true;
+  std::vector<std::atomic<int>> calls(count);
+  WorkerPool pool;
+  for (int r = 0; r < rounds && isOk; r++) {
+    // A new thread count every round, like changing the GUI between ticks.
+    pool.setup(threadCounts[r % threadCounts.size()]);
+    for (int job = 0; job < 2; job++) {
+      for (auto &c : calls) {
+        c = 0;
+      }
+      pool.parallelFor(count, [&](int idx) {
+        calls[idx]++;
+      });
+      for (int i = 0; i < count; i++) {
+        if (calls[i] != 1) {
+          cout << "FAIL workers: index " << i << " ran " << calls[i] << " times, round " << r << endl;
+          isOk = false;
+        }
+      }
+    }
+  }
+
+  isDone = true;
+  watchdog.join();
+  if (isOk) {
+    cout << "OK workers: " << rounds << " setups" << endl;
+  }
+  return isOk;
+}
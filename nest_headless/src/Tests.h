@@ -0,0 +1,14 @@
+// Checks for the simulation core that need threads or timing to go wrong, so a run of
+// the headless runner can't show them. Run with: nest_headless --test <name>
+#pragma once
+#include "ofMain.h"
+
+class Tests {
+  public:
+    // Runs the test with this name. Returns false if it fails or there is no such test.
+    static bool run(std::string name);
+
+    // WorkerPool: setup and a parallelFor right after it, many times over, at a few
+    // thread counts. Every index runs exactly once and nothing hangs.
+    static bool workerPool();
+};
@@ -0,0 +1,42 @@
+#include "ofMain.h"
+#include "Benchmarks.h"
+#include "Runner.h"
+#include "Tests.h"
+
+// Usage: nest_headless [frames] [agents] [people] [meshRows] [meshColumns] [physicsHz] [renderHz] [threads]
+//        nest_headless --bench <name> [args]
+//        nest_headless --test <name>
+//========================================================================
+int main(int argc, char *argv[]){
+	ofInit(); // No window, no GL context.
+
+	if (argc > 2 && std::string(argv[1]) == "--bench") {
+		std::vector<std::string> args(argv + 3, argv + argc);
+		if (!Benchmarks::run(argv[2], args)) {
+			cout << "ERROR: Unknown benchmark " << argv[2] << endl;
+			return 1;
+		}
+		return 0;
+	}
+
+	if (argc > 2 && std::string(argv[1]) == "--test") {
+		return Tests::run(argv[2]) ? 0 : 1;
+	}
+
+	RunnerSettings settings;
+	if (argc > 1) settings.frames = ofToInt(argv[1]);
+	if (argc > 2) settings.numAgents = ofToInt(argv[2]);
+	if (argc > 3) settings.numPeople = ofToInt(argv[3]);
+	if (argc > 4) settings.meshRows = ofToInt(argv[4]);
+	if (argc > 5) settings.meshColumns = ofToInt(argv[5]);
+	if (argc > 6) settings.physicsHz = ofToFloat(argv[6]);
+	if (argc > 7) settings.renderHz = ofToFloat(argv[7]);
+	if (argc > 8) settings.threads = ofToInt(argv[8]);
+
+	Runner runner;
+	runner.setup(settings);
+	runner.run();
+	runner.report();
+
+	return 0;
+}
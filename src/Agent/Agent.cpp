@@ -1,36 +1,24 @@
 #include "Agent.h"
 
-
-// ------------------------------ Message --------------------------------------- //
-Message::Message(glm::vec2 loc, ofColor col, float s) {
-  location = loc;
-  color = col;
-  size = s;
-}
-
-void Message::draw() {
-  ofPushMatrix();
-    ofTranslate(location);
-      ofPushStyle();
-        ofColor c = ofColor(color, 250);
-        ofSetColor(c);
-        ofDrawCircle(0, 0, size);
-      ofPopStyle();
-  ofPopMatrix();
-}
-
 // ------------------------------ Agent --------------------------------------- //
 
 void Agent::setup(ofxBox2d &box2d, ofPoint textureSize) {
-  // ACTIVE filter
-  filter = new PerlinPixellationFilter(textureSize.x, textureSize.y, 15.f);
+  // The renderer skins the agent with this (textures need the GL thread).
+  auto s = std::make_shared<AgentShape>();
+  s->mesh = mesh;
+  s->palette = palette;
+  s->textureSize = textureSize;
+  s->vertexRadius = vertices.size() > 0 ? vertices[0]->getRadius() : 0;
+  shape = s;
   
-  // Num messages to inscribe on the texture.
-  this->numMessages = 100; 
+  // Bodies of the soft body created by the derived class.
+  bodies.clear();
+  for (auto &v : vertices) {
+    bodies.push_back(v->body);
+  }
   
-  // This is common for both the agents. 
-  createTexture(textureSize);
-  curMsg = messages.begin(); // Need the message to draw
+  // Summary of the freshly created mesh.
+  updateKinematics();
   
   // Current desire state. 
   currentBehavior = Behavior::None;
@@ -43,70 +31,43 @@ void Agent::setup(ofxBox2d &box2d, ofPoint textureSize) {
   maxCoolDown = ofRandom(85, 175); // Wait time before the agent actually is ready to take more forces.
   stretchCounter = 0;
   maxStretchCounter = ofRandom(75, 125);
+  rng.seed(ofRandom(std::numeric_limits<int>::max())); // Behaviors don't share ofRandom's state.
   
   // Patch gate
   gate_ctrl >> instrument.in_trig();
 }
 
-void Agent::update(AlphaAgentProperties alphaProps, BetaAgentProperties betaProps) {
-  // Print the velocity of vertices.
-  for (auto &v : vertices) {
-    auto vel = v->getVelocity().length();
-    if (vel > maxVelocity) {
-      // Normalize current velocity and multiply it by 20
-      auto n = v->getVelocity().normalize();
-      n = n * maxVelocity; // Max velocity weight
-      v->setVelocity(n.x, n.y);
-    }
-  }
+void Agent::syncMesh(AlphaAgentProperties alphaProps, BetaAgentProperties betaProps) {
+  // Update local mesh.
+  updateMesh();
+  updateKinematics();
+}
+
+// Behaviors only read the bodies and write into the force buffer, so agents can run
+// this on different threads.
+void Agent::computeForces(float t) {
+  ticks = t;
+  forces.load(bodies);
+  forces.clampVelocity(maxVelocity);
   
   // Agent behaviors
   handleBehaviors();
 }
 
-void Agent::draw(bool showVisibilityRadius, bool showTexture) {
- // Draw the mesh vertices as soft bodies
- // Get the radius of the soft body and change the size.
- auto bodyRadius = this->vertices[0]->getRadius();
- glPointSize(bodyRadius*2);
- 
- ofPushStyle();
-  ofSetColor(ofColor::red);
-  mesh.draw(OF_MESH_POINTS);
- ofPopStyle();
-  
-  if (secondFbo.isAllocated()) {
-    if (showTexture) {
-      secondFbo.getTexture().bind();
-        mesh.draw();
-      secondFbo.getTexture().unbind();
-    } else {
-      ofPushStyle();
-      for(auto j: joints) {
-        ofPushMatrix();
-          ofSetColor(ofColor::green);
-          j->draw();
-        ofPopMatrix();
-      }
-      ofPopStyle();
-    }
-  }
-  
-  if (showVisibilityRadius) {
-    ofPushStyle();
-      ofNoFill();
-      ofSetColor(ofColor::yellow);
-      ofDrawCircle(getCentroid(), visibilityRadius);
-    ofPopStyle();
-  }
+void Agent::applyForces() {
+  forces.apply(bodies);
 }
 
-bool Agent::canExplode() {
-  return stretchCounter > maxStretchCounter; 
+float Agent::random(float min, float max) {
+  return std::uniform_real_distribution<float>(min, max)(rng);
 }
 
-ofPoint Agent::getTextureSize() {
-  return ofPoint(secondFbo.getWidth(), secondFbo.getHeight());
+float Agent::getLerpAmount(float amountPerFrame) {
+  return ticks == 1 ? amountPerFrame : 1 - std::pow(1 - amountPerFrame, ticks);
+}
+
+bool Agent::canExplode() {
+  return stretchCounter > maxStretchCounter; 
 }
 
 void Agent::clean(ofxBox2d &box2d) {
@@ -131,54 +92,8 @@ void Agent::clean(ofxBox2d &box2d) {
   // Clear all.
   joints.clear();
   vertices.clear();
-}
-
-void Agent::createTexture(ofPoint textureSize) {
-  // Create spots on the agent's body
-  for (int i = 0; i < numMessages; i++) {
-    // Pick a random location on the mesh.
-    int w = textureSize.x; int h = textureSize.y;
-    auto x = ofRandom(0, w); auto y = ofRandom(0, h);
-    
-    // Pick a random color for the message (anything except the background)
-    int idx = ofRandom(1, palette.size());
-    ofColor c = ofColor(palette.at(idx));
-    
-    // Pick a random size (TOOD: Based off on the length of the message).
-    int size = ofRandom(10, 15);
-    
-    // Create a message.
-    Message m = Message(glm::vec2(x, y), c, size);
-    messages.push_back(m);
-  }
-  
-  // Create 1st fbo and draw all the messages. 
-  firstFbo.allocate(textureSize.x*2, textureSize.y*2, GL_RGBA);
-  firstFbo.begin();
-    ofClear(0, 0, 0, 0);
-  
-    // Assign background.
-    int randIdx = ofRandom(palette.size());
-    ofColor c = ofColor(palette.at(randIdx), 250);
-    ofBackground(c);
-  
-    // Draw assigned messages.
-    for (auto m : messages) {
-      m.draw();
-    }
-
-  firstFbo.end();
-  
-  if (firstFbo.isAllocated()) {
-    // Create 2nd fbo and draw with filter and postProcessing
-    secondFbo.allocate(textureSize.x, textureSize.y, GL_RGBA);
-    secondFbo.begin();
-      ofClear(0, 0, 0, 0);
-      filter->begin();
-        firstFbo.getTexture().drawSubsection(0, 0, textureSize.x, textureSize.y, 0, 0);
-      filter->end();
-    secondFbo.end();
-  }
+  bodies.clear();
+  previousPositions.clear();
 }
 
 void Agent::handleBehaviors() {
@@ -194,18 +109,18 @@ void Agent::handleBehaviors() {
   
   // Cool the agent if need be.
   if (coolDown > 0) {
-    coolDown--;
+    coolDown = std::max(coolDown - ticks, 0.0f);
   }
 }
 
 void Agent::handleVertexBehaviors() {
-  for (auto &v : vertices) {
+  for (int i = 0; i < vertices.size(); i++) {
+    auto &v = vertices[i];
     auto data = reinterpret_cast<VertexData*>(v->getData());
     
     // Repulsion.
     if (data->applyRepulsion) {
-      auto pos = data->targetPos;
-      v->addRepulsionForce(pos.x, pos.y, maxRepulsionWeight);
+      forces.addRepulsion(i, data->targetPos, maxRepulsionWeight);
       
       // Reset repulsion parameter on the vertex.
       data->applyRepulsion = false;
@@ -214,8 +129,7 @@ void Agent::handleVertexBehaviors() {
     
     // Attraction.
     if (data->applyAttraction) {
-      auto pos = data->targetPos;
-      v->addAttractionPoint({pos.x, pos.y}, maxAttractionWeight);
+      forces.addAttraction(i, data->targetPos, maxAttractionWeight);
       
       // Reset repulsion parameter on the vertex.
       data->applyAttraction = false;
@@ -225,13 +139,13 @@ void Agent::handleVertexBehaviors() {
 }
 
 void Agent::handleRepulsion() {
-  if (currentBehavior==Behavior::Repel && coolDown == 0) {
+  if (currentBehavior==Behavior::Repel && coolDown <= 0) {
     for (auto targetPos : targetPositions) {
       float newMaxWeight = maxRepulsionWeight/100;
-      repulsionWeight = ofLerp(repulsionWeight, newMaxWeight, 0.01);
+      repulsionWeight = ofLerp(repulsionWeight, newMaxWeight, getLerpAmount(0.01));
       // Pick a random vertex and repel it away from the target position
-      auto randIdx = ofRandom(vertices.size());
-      vertices[randIdx]->addRepulsionForce(targetPos.x, targetPos.y, newMaxWeight);
+      int randIdx = std::min<int>(random(0, vertices.size()), vertices.size() - 1);
+      forces.addRepulsion(randIdx, targetPos, newMaxWeight);
       if (newMaxWeight - repulsionWeight <= 0.01) {
         repulsionWeight = 0;
         coolDown = maxCoolDown;
@@ -242,14 +156,14 @@ void Agent::handleRepulsion() {
 }
 
 void Agent::handleSpecialRepulsion() {
-  if (currentBehavior==Behavior::SpecialRepel && coolDown == 0) {
+  if (currentBehavior==Behavior::SpecialRepel && coolDown <= 0) {
     for (auto targetPos : targetPositions) {
       float newMaxWeight = maxRepulsionWeight/90;
-      repulsionWeight = ofLerp(repulsionWeight, newMaxWeight, 0.01);
-      for (auto &v : vertices) {
-        auto data = reinterpret_cast<VertexData*>(v->getData());
+      repulsionWeight = ofLerp(repulsionWeight, newMaxWeight, getLerpAmount(0.01));
+      for (int i = 0; i < vertices.size(); i++) {
+        auto data = reinterpret_cast<VertexData*>(vertices[i]->getData());
         if (data->hasInterAgentJoint) {
-          v->addRepulsionForce(targetPos.x, targetPos.y, repulsionWeight);
+          forces.addRepulsion(i, targetPos, repulsionWeight);
         }
       }
       
@@ -263,17 +177,12 @@ void Agent::handleSpecialRepulsion() {
 }
 
 void Agent::handleAttraction() {
-  if (currentBehavior==Behavior::Attract && coolDown == 0) {
+  if (currentBehavior==Behavior::Attract && coolDown <= 0) {
     for (auto targetPos : targetPositions) {
-          // Find the closest vertex to the targetPos.
-          float minD = 9999; int minIdx;
-          for (int idx = 0; idx < vertices.size(); idx++) {
-            auto v = vertices[idx];
-            auto p = glm::vec2(v->getPosition().x, v->getPosition().y);
-            auto d = glm::distance(p, targetPos);
-            if (d < minD) {
-              minD = d; minIdx = idx;
-            }
+          // Find the vertex closest to the targetPos (about, see VertexLocator).
+          int minIdx = getClosestVertex(targetPos);
+          if (minIdx < 0) {
+            continue;
           }
       
           // This weight is 100 times less than the maxAttraction weight because it
@@ -281,8 +190,8 @@ void Agent::handleAttraction() {
           // creature has a stretch/bacteria like feeling. The force is still applied
           // on the closest vertex from the person.
           float newMaxWeight = maxAttractionWeight/100;
-          attractionWeight = ofLerp(attractionWeight, newMaxWeight, 0.01);
-          vertices[minIdx]->addAttractionPoint(targetPos, attractionWeight);
+          attractionWeight = ofLerp(attractionWeight, newMaxWeight, getLerpAmount(0.01));
+          forces.addAttraction(minIdx, targetPos, attractionWeight);
           if (newMaxWeight - attractionWeight <= 0.01) {
             attractionWeight = 0;
             coolDown = maxCoolDown;
@@ -295,27 +204,22 @@ void Agent::handleAttraction() {
 void Agent::handleStretch() {
   // Check for counter.
   if (currentBehavior==Behavior::Stretch) { // Time to apply a stretch.
-    stretchWeight = ofLerp(stretchWeight, maxStretchWeight, 0.005);
-    for (auto &v : vertices) {
-      v->addRepulsionForce(mesh.getCentroid().x, mesh.getCentroid().y, stretchWeight);
-    }
+    stretchWeight = ofLerp(stretchWeight, maxStretchWeight, getLerpAmount(0.005));
+    forces.addRepulsionAll(kinematics.centroid, stretchWeight);
     
     if (maxStretchWeight - stretchWeight <= maxStretchWeight/2) {
       stretchWeight = 0;
     }
     currentBehavior = Behavior::None;
-    stretchCounter++; // Stretched. 
+    stretchCounter += ticks; // Stretched. 
   }
 }
 
 void Agent::handleShock() {
   // Does the agent want to tickle? Check with counter conditions.
-  if (currentBehavior==Behavior::Shock && coolDown == 0) {
+  if (currentBehavior==Behavior::Shock && coolDown <= 0) {
     // Apply the tickle.
-    for (auto &v: vertices) {
-      glm::vec2 force = glm::vec2(ofRandom(-2, 2), ofRandom(-2, 2));
-      v -> addForce(force, maxTickleWeight);
-    }
+    forces.addJitter(2 * maxTickleWeight, rng);
     
     // Reset state.
     currentBehavior = Behavior::None;
@@ -323,17 +227,104 @@ void Agent::handleShock() {
   }
 }
 
+void Agent::updateMesh() {
+  // Write the body positions straight into the mesh's vertex buffer. The world to
+  // screen scale is applied here once instead of per getPosition() call.
+  auto &meshPoints = mesh.getVertices();
+  auto numPoints = std::min(meshPoints.size(), bodies.size());
+  auto dst = meshPoints.data();
+  auto src = bodies.data();
+  for (int i = 0; i < numPoints; i++) {
+    const b2Vec2 &pos = src[i]->GetPosition();
+    dst[i].x = pos.x * OFX_BOX2D_SCALE;
+    dst[i].y = pos.y * OFX_BOX2D_SCALE;
+  }
+}
+
+void Agent::storePhysicsState() {
+  previousPositions.resize(bodies.size());
+  for (int i = 0; i < bodies.size(); i++) {
+    const b2Vec2 &pos = bodies[i]->GetPosition();
+    previousPositions[i] = glm::vec2(pos.x * OFX_BOX2D_SCALE, pos.y * OFX_BOX2D_SCALE);
+  }
+}
+
+void Agent::interpolateMesh(float alpha) {
+  // Agents born during this frame have no previous state yet.
+  if (previousPositions.size() != bodies.size()) {
+    updateMesh();
+    return;
+  }
+  
+  auto &meshPoints = mesh.getVertices();
+  auto numPoints = std::min(meshPoints.size(), bodies.size());
+  for (int i = 0; i < numPoints; i++) {
+    const b2Vec2 &pos = bodies[i]->GetPosition();
+    auto cur = glm::vec2(pos.x * OFX_BOX2D_SCALE, pos.y * OFX_BOX2D_SCALE);
+    auto p = glm::mix(previousPositions[i], cur, alpha);
+    meshPoints[i].x = p.x;
+    meshPoints[i].y = p.y;
+  }
+}
+
 glm::vec2 Agent::getCentroid() {
-  return mesh.getCentroid();
+  return kinematics.centroid;
+}
+
+int Agent::getClosestVertex(glm::vec2 target) {
+  return vertexLocator.getClosest(mesh.getVertices(), target);
+}
+
+const AgentKinematics& Agent::getKinematics() {
+  return kinematics;
+}
+
+void Agent::updateKinematics() {
+  auto &meshPoints = mesh.getVertices();
+  if (meshPoints.size() == 0) {
+    return;
+  }
+  
+  // Centroid and bounding box in one pass.
+  glm::vec2 sum(0, 0);
+  glm::vec2 minP(meshPoints[0].x, meshPoints[0].y);
+  glm::vec2 maxP = minP;
+  for (auto &p : meshPoints) {
+    sum.x += p.x; sum.y += p.y;
+    minP.x = std::min(minP.x, p.x); minP.y = std::min(minP.y, p.y);
+    maxP.x = std::max(maxP.x, p.x); maxP.y = std::max(maxP.y, p.y);
+  }
+  kinematics.centroid = sum / (float) meshPoints.size();
+  kinematics.bounds.set(minP, maxP.x - minP.x, maxP.y - minP.y);
+  
+  // Bounding radius around the centroid.
+  float maxDistSq = 0;
+  for (auto &p : meshPoints) {
+    auto d = glm::vec2(p.x, p.y) - kinematics.centroid;
+    maxDistSq = std::max(maxDistSq, glm::dot(d, d));
+  }
+  kinematics.radius = sqrt(maxDistSq);
+  
+  // Mean velocity of the bodies.
+  glm::vec2 vel(0, 0);
+  for (auto &v : vertices) {
+    glm::vec2 bodyVel = v->getVelocity();
+    vel += bodyVel;
+  }
+  kinematics.velocity = vertices.size() > 0 ? vel / (float) vertices.size() : vel;
 }
 
 ofMesh& Agent::getMesh() {
   return mesh;
 }
 
-void Agent::setBehavior(Behavior newBehavior, std::vector<glm::vec2> newTargets, bool overrideCoolDown) {
+std::shared_ptr<const AgentShape> Agent::getShape() {
+  return shape;
+}
+
+void Agent::setBehavior(Behavior newBehavior, const std::vector<glm::vec2> &newTargets, bool overrideCoolDown) {
   // Override the cool down if that flag is true. 
-  if (overrideCoolDown || (coolDown == 0 && currentBehavior == Behavior::None)) {
+  if (overrideCoolDown || (coolDown <= 0 && currentBehavior == Behavior::None)) {
     if (overrideCoolDown == true) {
       coolDown = 0;
     }
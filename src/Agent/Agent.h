@@ -1,8 +1,9 @@
 #pragma once
 #include "ofMain.h"
 #include "ofxBox2d.h"
-#include "ofxFilterLibrary.h"
 #include "Instrument.h"
+#include "VertexLocator.h"
+#include "ForceBuffer.h"
 
 // Current behavior of the agent.
 enum Behavior {
@@ -14,20 +15,6 @@ enum Behavior {
   Shock
 };
 
-// Every agent is inscribed with certain messages. Right now they are just
-// used to create a texture for the agent. They might be used as certain
-// communicative elements between messages. Not sure what it could be but
-// could be something interesting. 
-class Message {
-  public:
-    Message(glm::vec2 loc, ofColor col, float size);
-    void draw();
-  
-    glm::vec2 location;
-    ofColor color;
-    float size;
-};
-
 // Agent Props.
 struct AgentProps {
   ofPoint meshOrigin;
@@ -57,12 +44,35 @@ struct BetaAgentProperties : public AgentProps {
   ofPoint sideJointPhysics;
 };
 
+// Kinematic summary of an agent. It's computed once per frame right after the mesh
+// is synced with the box2d bodies, so queries and behaviors don't rescan the mesh.
+struct AgentKinematics {
+  glm::vec2 centroid;
+  ofRectangle bounds; // Axis aligned bounding box of the mesh.
+  float radius; // Bounding radius around the centroid.
+  glm::vec2 velocity; // Mean velocity of the vertices.
+};
+
+// What the renderer needs to draw an agent that never changes after it's created:
+// the mesh topology with its texture coordinates and what its skin looks like.
+struct AgentShape {
+  ofMesh mesh; // Vertices are where the agent was born.
+  std::vector<ofColor> palette;
+  ofPoint textureSize;
+  float vertexRadius;
+};
+
 // Subsection body that is torn apart from the actual texture and falls on the ground. 
 class Agent {
   public:
     void setup(ofxBox2d &box2d, ofPoint textureSize);
-    void draw(bool showVisibilityRadius, bool showTexture);
-    virtual void update(AlphaAgentProperties alphaProps, BetaAgentProperties betaProps);
+  
+    // Frame phases. Nest runs every agent through each of them once per frame.
+    virtual void syncMesh(AlphaAgentProperties alphaProps, BetaAgentProperties betaProps); // Mesh + GUI props.
+    // Velocity clamp + behaviors. Thread safe, only touches this agent. ticks: how long
+    // the step is in 60 Hz frames, which the counters and lerps were tuned at.
+    void computeForces(float ticks = 1);
+    void applyForces(); // Writes to box2d, main thread only.
   
     // Clean the agent
     void clean(ofxBox2d &box2d);
@@ -78,33 +88,36 @@ class Agent {
     void agentStretchSound(bool on);
     void handleExplosion();
   
+    // Sync the mesh with the box2d bodies.
+    virtual void updateMesh();
+  
+    // Fixed timestep: remember the bodies before a physics step, then draw the mesh
+    // in between that state and the current one.
+    void storePhysicsState();
+    void interpolateMesh(float alpha);
+  
     // Helpers
     glm::vec2 getCentroid();
+    int getClosestVertex(glm::vec2 target); // About the closest, see VertexLocator.
+    const AgentKinematics& getKinematics();
     ofMesh& getMesh();
-    void setBehavior(Behavior behavior, std::vector<glm::vec2> pos = {}, bool overrideCoolDown = false);
+    std::shared_ptr<const AgentShape> getShape();
+    void setBehavior(Behavior behavior, const std::vector<glm::vec2> &pos = {}, bool overrideCoolDown = false);
     bool canExplode();
   
     // Vertices and Joints
     std::vector<std::shared_ptr<ofxBox2dCircle>> vertices; // Every vertex in the mesh is a circle.
     std::vector<std::shared_ptr<ofxBox2dJoint>> joints; // Joints connecting those vertices.
   
-    // Texture
-    void createTexture(ofPoint meshSize);
-    ofPoint getTextureSize();
-  
-    // Public iterator to access messages. 
-    std::vector<Message>::iterator curMsg;
-    std::vector<Message> messages;
-  
     // Current behavior of the agent.
     Behavior currentBehavior;
   
     // Visibility Radius
     float visibilityRadius;
   
-    // Counter to keep track of the time spent on each agent when interacting with it. 
-    int stretchCounter;
-    int maxStretchCounter;
+    // Counter to keep track of the time spent on each agent when interacting with it (60 Hz frames).
+    float stretchCounter;
+    float maxStretchCounter;
   
     // Instrument control.
     Instrument instrument;
@@ -113,9 +126,7 @@ class Agent {
 
   protected:
     // Derived class needs to have access to these. 
-    int numMessages; // Number of messages each agent has
     std::vector<ofColor> palette;
-    AbstractFilter *filter;
   
     // Weights
     float maxStretchWeight;
@@ -131,30 +142,50 @@ class Agent {
   
     // Each derived class will override these methods as they define their own
     // meshes and soft bodies.
-    virtual void updateMesh() {};
     virtual void updateWeights(AgentProps props) {}; 
   
+    // Summarize the mesh once it's been updated.
+    void updateKinematics();
+    AgentKinematics kinematics;
+  
+    // Derived class fills the boundary of its mesh and the neighbors (joints)
+    // of every vertex.
+    vector<int> boundaryIndices;
+    VertexLocator vertexLocator;
+  
     // Mesh must be accessible in the derived class. 
     ofMesh mesh;
+  
+    // Box2d bodies of the vertices (same order as the mesh), so the mesh sync
+    // doesn't go through the shapes.
+    std::vector<b2Body *> bodies;
+    std::vector<glm::vec2> previousPositions; // Before the last physics step (screen).
+  
+    // Forces of this tick, applied to the bodies in applyForces().
+    ForceBuffer forces;
+  
+    // Randomness of the behaviors. Every agent has its own, so the result doesn't
+    // depend on the order (or the threads) the agents run in.
+    std::mt19937 rng;
+    float random(float min, float max);
+
+    // Length of this step in 60 Hz frames, and a per frame lerp amount over it.
+    float ticks = 1;
+    float getLerpAmount(float amountPerFrame);
     
   private:
     // ----------------- Data members -------------------
-    // Texture
-    ofFbo firstFbo;
-    ofFbo secondFbo;
-    ofFbo textFbo;
-    ofTrueTypeFont font;
+    std::shared_ptr<const AgentShape> shape;
   
     // Figment's corner indices
     int cornerIndices[4];
-    vector<int> boundaryIndices;
   
     // Target position for behaviors
     std::vector<glm::vec2> targetPositions;
   
-    // Wait time before being able to be applied with another force. 
-    int coolDown;
-    int maxCoolDown;
+    // Wait time before being able to be applied with another force (60 Hz frames).
+    float coolDown;
+    float maxCoolDown;
 };
 
 // Data Structure to hold a pointer to the agent instance
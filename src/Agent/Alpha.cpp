@@ -31,7 +31,7 @@ Alpha::Alpha(ofxBox2d &box2d, AlphaAgentProperties agentProps) {
   createMesh(agentProps);
   createSoftBody(box2d, agentProps);
   
-  // Let the parent class setup the rest of the Agent (especially Texture)
+  // Let the parent class setup the rest of the Agent
   setup(box2d, agentProps.textureSize);
 }
 
@@ -105,6 +105,14 @@ void Alpha::createSoftBody(ofxBox2d &box2d, AlphaAgentProperties agentProps) {
   int meshRows = agentProps.meshRowsColumns.x;
   int meshColumns = agentProps.meshRowsColumns.y;
   
+  // Boundary of the grid, walking around it: top row, right column, bottom row, left column.
+  boundaryIndices.clear();
+  for (int x = 0; x < meshColumns; x++) boundaryIndices.push_back(x);
+  for (int y = 1; y < meshRows; y++) boundaryIndices.push_back(y * meshColumns + meshColumns - 1);
+  for (int x = meshColumns - 2; x >= 0; x--) boundaryIndices.push_back((meshRows - 1) * meshColumns + x);
+  for (int y = meshRows - 2; y > 0; y--) boundaryIndices.push_back(y * meshColumns);
+  vertexLocator.setup(boundaryIndices, vertices.size());
+  
   // Create Box2d joints for the mesh.
   for (int y = 0; y < meshRows; y++) {
     for (int x = 0; x < meshColumns; x++) {
@@ -117,6 +125,7 @@ void Alpha::createSoftBody(ofxBox2d &box2d, AlphaAgentProperties agentProps) {
         int rightIdx = idx + 1;
         joint -> setup(box2d.getWorld(), vertices[idx] -> body, vertices[rightIdx] -> body, agentProps.jointPhysics.x, agentProps.jointPhysics.y); // frequency, damping
         joints.push_back(joint);
+        vertexLocator.addNeighbor(idx, rightIdx);
       }
       
       // Do this for each row except the last row. There is no further joint to
@@ -126,39 +135,21 @@ void Alpha::createSoftBody(ofxBox2d &box2d, AlphaAgentProperties agentProps) {
         int downIdx = x + (y + 1) * meshColumns;
         joint -> setup(box2d.getWorld(), vertices[idx] -> body, vertices[downIdx] -> body, agentProps.jointPhysics.x, agentProps.jointPhysics.y);
         joints.push_back(joint);
+        vertexLocator.addNeighbor(idx, downIdx);
       }
     }
   }
 }
 
-void Alpha::updateMesh() {
-  auto meshPoints = mesh.getVertices();
-  
-  for (int j = 0; j < meshPoints.size(); j++) {
-    // Get the box2D vertex position.
-    glm::vec2 pos = vertices[j]->getPosition();
-    
-    // Update mesh point's position with the position of
-    // the box2d vertex.
-    auto meshPoint = meshPoints[j];
-    meshPoint.x = pos.x;
-    meshPoint.y = pos.y;
-    mesh.setVertex(j, meshPoint);
-  }
-}
-
-void Alpha::update(AlphaAgentProperties alphaProps, BetaAgentProperties betaProps) {
+void Alpha::syncMesh(AlphaAgentProperties alphaProps, BetaAgentProperties betaProps) {
   // Update local mesh. 
-  updateMesh();
+  Agent::syncMesh(alphaProps, betaProps);
   
   // Weights
   updateWeights(alphaProps);
   
   // Visibility Radius update from the GUI.
   visibilityRadius = (alphaProps.meshSize.x/2) * alphaProps.visibilityRadiusFactor;
-  
-  // Call base class's update method.
-  Agent::update(alphaProps, betaProps);
 }
 
 void Alpha::updateWeights(AlphaAgentProperties agentProps) {
@@ -10,12 +10,11 @@ class Alpha : public Agent {
     Alpha(ofxBox2d &box2d, AlphaAgentProperties agentProps);
   
     // Overriding methods. 
-    void updateMesh();
     void createMesh(AlphaAgentProperties softBodyProperties);
     void createSoftBody(ofxBox2d &box2d, AlphaAgentProperties softBodyProperties);
     void updateWeights(AlphaAgentProperties alphaProps);
   
-    void update(AlphaAgentProperties alphaProps, BetaAgentProperties betaProps);
+    void syncMesh(AlphaAgentProperties alphaProps, BetaAgentProperties betaProps);
 };
 
 struct AgentProperties {
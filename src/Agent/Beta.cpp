@@ -79,6 +79,13 @@ void Beta::createSoftBody(ofxBox2d &box2d, BetaAgentProperties agentProps) {
     vertices.push_back(vertex);
   }
   
+  // Everything except the center is on the boundary.
+  boundaryIndices.clear();
+  for (int i = 1; i < vertices.size(); i++) {
+    boundaryIndices.push_back(i);
+  }
+  vertexLocator.setup(boundaryIndices, vertices.size());
+  
   // Connect center vertex to all the vertices.
   // Start from 1st vertex because the 0th vertex (center) is connected other vertices on the boundary.
   // We go 1 less than the mesh points because last point in the mesh is the same as the second point (after center).
@@ -87,6 +94,7 @@ void Beta::createSoftBody(ofxBox2d &box2d, BetaAgentProperties agentProps) {
     joint->setup(box2d.getWorld(), vertices[0] -> body, vertices[i] -> body, agentProps.centerJointPhysics.x, agentProps.centerJointPhysics.y);
     joint->setLength(agentProps.meshRadius);
     joints.push_back(joint);
+    vertexLocator.addNeighbor(0, i);
   }
   
   // Connect joints with each other.
@@ -101,35 +109,19 @@ void Beta::createSoftBody(ofxBox2d &box2d, BetaAgentProperties agentProps) {
 
     // Note: Outer Joint should have a seperate prop passed in for Azra's joints.
     joint->setup(box2d.getWorld(), vertices[fromIdx] -> body, vertices[toIdx] -> body, agentProps.sideJointPhysics.x, agentProps.sideJointPhysics.y);
+    vertexLocator.addNeighbor(fromIdx, toIdx);
   }
 }
 
-void Beta::updateMesh() {
- for (int i = 0; i < mesh.getVertices().size() ; i++) {
-    // Get ith circle's position.
-    glm::vec2 pos = vertices[i] -> getPosition();
-  
-    // Update ith mesh vertex's position.
-    auto vertex = mesh.getVertices()[i];
-    vertex.x = pos.x;
-    vertex.y = pos.y;
-    mesh.setVertex(i, vertex);
-  }
-}
-
-
-void Beta::update(AlphaAgentProperties alphaProps, BetaAgentProperties betaProps) {
+void Beta::syncMesh(AlphaAgentProperties alphaProps, BetaAgentProperties betaProps) {
   // Update local mesh.
-  updateMesh();
+  Agent::syncMesh(alphaProps, betaProps);
   
   // Weights
   updateWeights(betaProps);
   
   // Update visibility radius with factor from GUI. 
   visibilityRadius = betaProps.meshRadius * betaProps.visibilityRadiusFactor;
-  
-  // Call base class's update method.
-  Agent::update(alphaProps, betaProps);
 }
 
 void Beta::updateWeights(BetaAgentProperties agentProps) {
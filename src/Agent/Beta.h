@@ -9,13 +9,11 @@ class Beta : public Agent {
     Beta(ofxBox2d &box2d, BetaAgentProperties agentProps);
   
     // Overridden methods.
-    void updateMesh();
     void createMesh(BetaAgentProperties softBodyProperties);
     void createSoftBody(ofxBox2d &box2d, BetaAgentProperties softBodyProperties);
     void updateWeights(BetaAgentProperties betaProps);
   
-    void update(AlphaAgentProperties alphaProps, BetaAgentProperties betaProps);
+    void syncMesh(AlphaAgentProperties alphaProps, BetaAgentProperties betaProps);
   
     int numMeshPoints;
-    void update(AgentProps alphaProps, AgentProps betaProps);
 };
@@ -0,0 +1,96 @@
+#include "ForceBuffer.h"
+
+void ForceBuffer::resize(int n) {
+  px.resize(n); py.resize(n);
+  vx.resize(n); vy.resize(n);
+  fx.resize(n); fy.resize(n);
+  clamped.resize(n);
+}
+
+void ForceBuffer::load(const std::vector<b2Body *> &bodies) {
+  int n = bodies.size();
+  resize(n);
+  for (int i = 0; i < n; i++) {
+    const b2Vec2 &pos = bodies[i]->GetPosition();
+    const b2Vec2 &vel = bodies[i]->GetLinearVelocity();
+    px[i] = pos.x; py[i] = pos.y;
+    vx[i] = vel.x; vy[i] = vel.y;
+  }
+  std::fill(fx.begin(), fx.end(), 0.f);
+  std::fill(fy.begin(), fy.end(), 0.f);
+  std::fill(clamped.begin(), clamped.end(), 0);
+}
+
+void ForceBuffer::addRepulsion(int idx, glm::vec2 target, float amt) {
+  fx[idx] -= amt * (target.x / OFX_BOX2D_SCALE - px[idx]);
+  fy[idx] -= amt * (target.y / OFX_BOX2D_SCALE - py[idx]);
+}
+
+void ForceBuffer::addAttraction(int idx, glm::vec2 target, float amt) {
+  fx[idx] += amt * (target.x / OFX_BOX2D_SCALE - px[idx]);
+  fy[idx] += amt * (target.y / OFX_BOX2D_SCALE - py[idx]);
+}
+
+void ForceBuffer::addRepulsionAll(glm::vec2 target, float amt) {
+  // Convert once, then a plain loop over the arrays.
+  float tx = target.x / OFX_BOX2D_SCALE; float ty = target.y / OFX_BOX2D_SCALE;
+  int n = size();
+  float *fxs = fx.data(); float *fys = fy.data();
+  const float *pxs = px.data(); const float *pys = py.data();
+  for (int i = 0; i < n; i++) {
+    fxs[i] -= amt * (tx - pxs[i]);
+    fys[i] -= amt * (ty - pys[i]);
+  }
+}
+
+void ForceBuffer::addForce(int idx, glm::vec2 force) {
+  fx[idx] += force.x;
+  fy[idx] += force.y;
+}
+
+void ForceBuffer::addJitter(float amt, std::mt19937 &rng) {
+  // Random numbers come one after the other, so this one stays serial.
+  std::uniform_real_distribution<float> dist(-amt, amt);
+  for (int i = 0; i < size(); i++) {
+    fx[i] += dist(rng);
+    fy[i] += dist(rng);
+  }
+}
+
+void ForceBuffer::clampVelocity(float maxVelocity) {
+  int n = size();
+  float maxSq = maxVelocity * maxVelocity;
+  const float *vxs = vx.data(); const float *vys = vy.data();
+  char *c = clamped.data();
+  // Only flag the fast ones here (no sqrt, so it vectorizes). Very few vertices
+  // are over the limit, they get scaled below.
+  int numClamped = 0;
+  for (int i = 0; i < n; i++) {
+    c[i] = vxs[i] * vxs[i] + vys[i] * vys[i] > maxSq;
+    numClamped += c[i];
+  }
+  
+  if (numClamped == 0) {
+    return;
+  }
+  
+  for (int i = 0; i < n; i++) {
+    if (c[i]) {
+      float scale = maxVelocity / sqrt(vx[i] * vx[i] + vy[i] * vy[i]);
+      vx[i] *= scale;
+      vy[i] *= scale;
+    }
+  }
+}
+
+void ForceBuffer::apply(const std::vector<b2Body *> &bodies) {
+  int n = std::min((int) bodies.size(), size());
+  for (int i = 0; i < n; i++) {
+    if (clamped[i]) {
+      bodies[i]->SetLinearVelocity(b2Vec2(vx[i], vy[i]));
+    }
+    if (fx[i] != 0 || fy[i] != 0) {
+      bodies[i]->ApplyForceToCenter(b2Vec2(fx[i], fy[i]), true);
+    }
+  }
+}
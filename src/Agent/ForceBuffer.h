@@ -0,0 +1,40 @@
+// Forces of one agent for the current tick, stored as flat arrays (one per component)
+// so the loops over all the vertices vectorize. Behaviors accumulate into it and it's
+// written back to the box2d bodies in a single pass, instead of going through
+// ofxBox2dBaseShape (unit conversion + ApplyForce) for every force on every vertex.
+// Everything in here is in box2d world units.
+#pragma once
+#include "ofMain.h"
+#include "ofxBox2d.h"
+
+class ForceBuffer {
+  public:
+    // Read positions and velocities of the bodies and reset the forces.
+    void load(const std::vector<b2Body *> &bodies);
+
+    // Push the vertex away from / pull it towards a screen point.
+    // Same force as ofxBox2dBaseShape: amt * (target - position).
+    void addRepulsion(int idx, glm::vec2 target, float amt);
+    void addAttraction(int idx, glm::vec2 target, float amt);
+    void addRepulsionAll(glm::vec2 target, float amt);
+    void addForce(int idx, glm::vec2 force);
+
+    // Random force in [-amt, amt] on every vertex.
+    void addJitter(float amt, std::mt19937 &rng);
+
+    // Scale down every velocity that is faster than maxVelocity.
+    void clampVelocity(float maxVelocity);
+
+    // Apply the forces and the clamped velocities to the bodies.
+    void apply(const std::vector<b2Body *> &bodies);
+
+    int size() const { return px.size(); }
+
+  private:
+    void resize(int n);
+
+    std::vector<float> px, py; // Position
+    std::vector<float> vx, vy; // Velocity
+    std::vector<float> fx, fy; // Force
+    std::vector<char> clamped; // Velocity changed this tick.
+};
@@ -0,0 +1,68 @@
+#include "JointMesh.h"
+#include "Agent.h"
+
+JointMesh::JointMesh() {
+  mesh.setMode(OF_PRIMITIVE_LINES);
+}
+
+void JointMesh::clear() {
+  for (auto b : bodies) {
+    setMeshIdx(b, -1);
+  }
+  bodies.clear();
+  mesh.clear();
+  mesh.setMode(OF_PRIMITIVE_LINES);
+}
+
+void JointMesh::add(b2Body *bodyA, b2Body *bodyB) {
+  int idx = bodies.size();
+  bodies.push_back(bodyA);
+  bodies.push_back(bodyB);
+  setMeshIdx(bodyA, idx);
+  setMeshIdx(bodyB, idx + 1);
+
+  auto posA = bodyA->GetWorldCenter(); auto posB = bodyB->GetWorldCenter();
+  mesh.addVertex(glm::vec3(posA.x * OFX_BOX2D_SCALE, posA.y * OFX_BOX2D_SCALE, 0));
+  mesh.addVertex(glm::vec3(posB.x * OFX_BOX2D_SCALE, posB.y * OFX_BOX2D_SCALE, 0));
+}
+
+void JointMesh::remove(b2Body *bodyA, b2Body *bodyB) {
+  auto data = reinterpret_cast<VertexData*>(bodyA->GetUserData());
+  int idx = data->jointMeshIdx;
+  if (idx < 0 || idx + 1 >= bodies.size() || bodies[idx] != bodyA || bodies[idx + 1] != bodyB) {
+    ofLogWarning("JointMesh") << "Removing a joint that isn't in the mesh.";
+    return;
+  }
+
+  // Move the last line into this one's place.
+  auto &vertices = mesh.getVertices();
+  int last = bodies.size() - 2;
+  if (idx != last) {
+    bodies[idx] = bodies[last];
+    bodies[idx + 1] = bodies[last + 1];
+    vertices[idx] = vertices[last];
+    vertices[idx + 1] = vertices[last + 1];
+    setMeshIdx(bodies[idx], idx);
+    setMeshIdx(bodies[idx + 1], idx + 1);
+  }
+  bodies.resize(last);
+  vertices.resize(last);
+  setMeshIdx(bodyA, -1);
+  setMeshIdx(bodyB, -1);
+}
+
+void JointMesh::update() {
+  auto &vertices = mesh.getVertices();
+  for (int i = 0; i < bodies.size(); i++) {
+    const b2Vec2 &pos = bodies[i]->GetWorldCenter();
+    vertices[i].x = pos.x * OFX_BOX2D_SCALE;
+    vertices[i].y = pos.y * OFX_BOX2D_SCALE;
+  }
+}
+
+void JointMesh::setMeshIdx(b2Body *body, int idx) {
+  auto data = reinterpret_cast<VertexData*>(body->GetUserData());
+  if (data != NULL) {
+    data->jointMeshIdx = idx;
+  }
+}
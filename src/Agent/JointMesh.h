@@ -0,0 +1,28 @@
+// Lines of all the inter-agent joints. Every joint owns two consecutive vertices of the
+// mesh, in the same order as the bodies it connects. Removing a joint moves the last
+// pair into its place, so breaking a bond never rebuilds the mesh.
+#pragma once
+#include "ofMain.h"
+#include "ofxBox2d.h"
+
+class JointMesh {
+  public:
+    JointMesh();
+    void clear();
+
+    // Adds the line between the two bodies and stores its vertex index in their VertexData.
+    void add(b2Body *bodyA, b2Body *bodyB);
+    void remove(b2Body *bodyA, b2Body *bodyB);
+
+    // Follow the bodies. One pass over all the lines.
+    void update();
+    const std::vector<glm::vec3> &getLines() { return mesh.getVertices(); } // Two points per joint.
+
+    int getNumJoints() const { return bodies.size() / 2; }
+
+  private:
+    void setMeshIdx(b2Body *body, int idx);
+
+    ofMesh mesh;
+    std::vector<b2Body *> bodies; // Body of every vertex.
+};
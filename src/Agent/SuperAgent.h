@@ -3,6 +3,7 @@
 #include "ofxBox2d.h"
 #include "Agent.h"
 #include "Memory.h"
+#include "JointMesh.h"
 
 // This class defines the entire BOND structure between two agents.
 // For every two agents that bond with each other, I create a SuperAgent class.
@@ -10,8 +11,7 @@
 class SuperAgent {
   public:
     void setup(Agent *agentA, Agent *agentB, std::shared_ptr<ofxBox2dJoint>);
-    void update(ofxBox2d &box2d, std::vector<Memory> &memories, bool &resetMesh, bool shouldBond);
-    void updateMeshIdx(); 
+    void update(ofxBox2d &box2d, std::vector<Memory> &memories, bool shouldBond);
     bool contains(Agent *agentA, Agent *agentB);
 	bool contains(Agent * agent);
     void clean(ofxBox2d &box2d);
@@ -19,12 +19,8 @@ class SuperAgent {
     glm::vec2 getBodyPosition(b2Body *body);
   
     // This is shared between all the SuperAgent instances to maintain.
-    static ofMesh jointMesh;
-    static int curMeshIdx;
+    static JointMesh jointMesh;
     static void initJointMesh(); 
-    static void insertJointMesh(glm::vec3 v1, glm::vec3 v2);
-    static void insertIndices(int idx1, int idx2); 
-    static void drawJointMesh();
   
     Agent *agentA;
     Agent *agentB;
@@ -0,0 +1,43 @@
+#include "VertexLocator.h"
+
+void VertexLocator::setup(std::vector<int> boundaryIndices, int numVertices) {
+  boundary = boundaryIndices;
+  neighbors.clear();
+  neighbors.resize(numVertices);
+}
+
+void VertexLocator::addNeighbor(int idxA, int idxB) {
+  neighbors[idxA].push_back(idxB);
+  neighbors[idxB].push_back(idxA);
+}
+
+int VertexLocator::getClosest(const std::vector<glm::vec3> &points, glm::vec2 target) const {
+  if (points.size() == 0 || boundary.size() == 0) {
+    return -1;
+  }
+  
+  // Coarse pass over the boundary.
+  float minD = std::numeric_limits<float>::max(); int minIdx = -1;
+  for (auto idx : boundary) {
+    auto diff = glm::vec2(points[idx].x, points[idx].y) - target;
+    auto d = glm::dot(diff, diff);
+    if (d < minD) {
+      minD = d; minIdx = idx;
+    }
+  }
+  
+  // Walk towards the target through the neighbors until nothing is closer.
+  bool moved = true;
+  while (moved) {
+    moved = false;
+    for (auto n : neighbors[minIdx]) {
+      auto diff = glm::vec2(points[n].x, points[n].y) - target;
+      auto d = glm::dot(diff, diff);
+      if (d < minD) {
+        minD = d; minIdx = n; moved = true;
+      }
+    }
+  }
+  
+  return minIdx;
+}
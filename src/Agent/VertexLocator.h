@@ -0,0 +1,21 @@
+// Answers "which vertex of the agent is closest to this point?" without scanning
+// every vertex. It only looks at the boundary of the mesh (a person or another agent
+// is mostly outside the body), then walks the joint topology towards the point in
+// case the closest vertex sits inside the boundary (a folded or dented body). The walk
+// stops where no neighbor is closer, so on a bent mesh it can settle on a vertex that
+// is close but not the closest (nest_headless --bench closest counts how often).
+#pragma once
+#include "ofMain.h"
+
+class VertexLocator {
+  public:
+    void setup(std::vector<int> boundaryIndices, int numVertices);
+    void addNeighbor(int idxA, int idxB); // Vertices connected by a joint.
+
+    // Index of an approximately closest vertex to the target (-1 if there are no vertices).
+    int getClosest(const std::vector<glm::vec3> &points, glm::vec2 target) const;
+
+  private:
+    std::vector<int> boundary;
+    std::vector<std::vector<int>> neighbors;
+};
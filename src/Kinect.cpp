@@ -1,88 +1,139 @@
 #include "Kinect.h"
 
 void Kinect::setup() {
-    //see how many devices we have.
+    kinectOpen = false;
+    isReplay = false;
+  
+    //see how many devices we have. Every one is a source.
     ofxKinectV2 tmp;
     std::vector <ofxKinectV2::KinectDeviceInfo> deviceList = tmp.getDeviceList();
-    if (deviceList.size() > 0) {
-      // Start Kinect.
-      kinectOpen = kinect.open(deviceList[0].serial);
-      // Setup GUI.
-      initialize();
-    } else {
+    for (int i = 0; i < deviceList.size(); i++) {
+      auto source = std::make_unique<KinectSource>();
+      if (source->openDevice(deviceList[i].serial, getSourceName(i))) {
+        sources.push_back(std::move(source));
+      }
+    }
+  
+    if (sources.empty()) {
       cout << "ERROR: Kinect not fuond.";
+      
+      // Recorded frames instead: Kinect.depth, Kinect1.depth, Kinect2.depth...
+      for (int i = 0; ofFile::doesFileExist(getSourceName(i) + ".depth"); i++) {
+        auto source = std::make_unique<KinectSource>();
+        if (source->openReplay(getSourceName(i) + ".depth", getSourceName(i))) {
+          sources.push_back(std::move(source));
+        }
+      }
+      isReplay = !sources.empty();
     }
   
+    kinectOpen = !sources.empty();
+    if (kinectOpen) {
+      ofLog() << "Depth sources: " << sources.size() << (isReplay ? " (replayed)" : "") << endl;
+      // Setup GUI.
+      initialize();
+    }
+}
+
+std::string Kinect::getSourceName(int idx) {
+  return idx == 0 ? "Kinect" : "Kinect" + ofToString(idx);
 }
 
 void Kinect::update() {
-    // Is there a valid Kinect connection?
     if (kinectOpen) {
-      // Update Kinect to process next frame.
-      kinect.update();
-      
-      // Process Kinect Data only when it's a new valid frame.
-      if (kinect.isFrameNew()) {
-          texRGB.loadData(kinect.getPixels());
-          texRGBRegistered.loadData(kinect.getRegisteredPixels());
-          texIR.loadData(kinect.getIRPixels());
-        
-          // Get depth pixels.
-          auto depthPixels = kinect.getDepthPixels();
-        
-          // [NOTE] Loading these pixels after ofxCv operations, I take a
-          // performance hit.
-          texDepth.loadData(depthPixels);
-        
-          // Add preprocessor effects.
-          ofxCv::blur(depthPixels, depthPixels, blurVal);
-          ofxCv::erode(depthPixels, depthPixels, erosion);
-          ofxCv::dilate(depthPixels, depthPixels, dilation);
-          ofxCv::threshold(depthPixels, depthPixels, imageThreshold);
-        
-          // Updated depth texture.
-          // If I reload texture here, I take a performance hit.
-
-          // Set contour finder's properties.
-          contourFinder.setMinAreaRadius(minArea);
-          contourFinder.setMaxAreaRadius(maxArea);
-          contourFinder.setThreshold(contourThreshold);
-          
-          // Find contours.
-          auto depthImgMat = ofxCv::toCv(depthPixels);
-          contourFinder.findContours(depthImgMat);
-        
-          // To fit the contours on top of the entire screen, we calculate scale.
-          auto xScale = ofGetWidth()/texDepth.getWidth();
-          auto yScale = ofGetHeight()/texDepth.getHeight();
-          scaleVariables = glm::vec2(xScale, yScale);
+      auto depthSettings = getSettings();
+      for (auto &source : sources) {
+        if (!source->isReplay && source->device.irExposure.get() != kinect.irExposure.get()) {
+          source->device.irExposure = kinect.irExposure.get(); // The GUI's goes to every device.
+        }
+        source->update(depthSettings);
       }
+      updateAudience();
     }
 }
 
+void Kinect::toggleRecording() {
+  for (auto &source : sources) {
+    source->toggleRecording();
+  }
+}
+
+void Kinect::exit() {
+  for (auto &source : sources) {
+    source->close();
+  }
+}
+
+DepthSettings Kinect::getSettings() {
+  DepthSettings settings;
+  settings.minDistance = kinect.minDistance;
+  settings.maxDistance = kinect.maxDistance;
+  settings.blur = blurVal;
+  settings.erosion = erosion;
+  settings.dilation = dilation;
+  settings.imageThreshold = imageThreshold;
+  settings.minArea = minArea;
+  settings.maxArea = maxArea;
+  settings.contourThreshold = contourThreshold;
+  settings.pyramidLevel = pyramidLevel;
+  settings.rescanInterval = rescanInterval;
+  settings.regionPadding = regionPadding;
+  settings.velocitySmoothing = velocitySmoothing;
+  settings.background = background;
+  settings.backgroundThreshold = backgroundThreshold;
+  settings.backgroundRate = backgroundRate;
+  settings.backgroundInterval = backgroundInterval;
+  return settings;
+}
+
 void Kinect::draw() {
     if (kinectOpen) {
+        // The first live Kinect's images.
+        auto &first = *sources[0];
+        if (!first.isReplay && first.getFrame().depth.isAllocated()) {
+          texRGB.loadData(first.device.getPixels());
+          texRGBRegistered.loadData(first.device.getRegisteredPixels());
+          texIR.loadData(first.device.getIRPixels());
+        }
+        for (auto &source : sources) {
+          if (source->getFrame().depth.isAllocated()) {
+            source->texDepth.loadData(source->getFrame().depth);
+          }
+        }
+      
         // Use the texture width, height as the baseline to draw all the 4 debug screens.
-        auto w = texDepth.getWidth(); auto h = texDepth.getHeight();
+        // Depth of the other sources goes right of them.
+        auto w = first.texDepth.getWidth(); auto h = first.texDepth.getHeight();
       
-        drawTextureAtRowAndColumn("Depth Pixels, Mapped", texDepth, 0, 0, w, h);
         drawTextureAtRowAndColumn("IR Pixels, Mapped", texIR, 0, 1, w, h);
         drawTextureAtRowAndColumn("RGB Pixels, Registered", texRGBRegistered, 1, 0, w, h);
         drawTextureAtRowAndColumn("RGB Pixels", texRGB, 1, 1, w, h);
-      
-        // Draw contours on top of the depth pixels with Age, Label.
-        ofPushMatrix();
-          ofPushStyle();
-            ofSetColor(ofColor::green);
-            ofSetLineWidth(3);
-            for (int i = 0; i < contourFinder.size(); i++) {
-              contourFinder.getPolyline(i).draw();
-              auto label = contourFinder.getLabel(i);
-              auto age = contourFinder.getTracker().getAge(label);
-              ofDrawBitmapStringHighlight(ofToString(label) + " : " + ofToString(age), ofxCv::toOf(contourFinder.getCenter(i)));
-            }
-          ofPopStyle();
-        ofPopMatrix();
+        for (int i = 0; i < sources.size(); i++) {
+          auto &frame = sources[i]->getFrame();
+          int row = i == 0 ? 0 : i + 1;
+          drawTextureAtRowAndColumn("Depth Pixels, Mapped (" + sources[i]->name + ")", sources[i]->texDepth, row, 0, w, h);
+        
+          // Draw contours on top of the depth pixels with Age, Label.
+          ofPushMatrix();
+            ofTranslate(row * w, 0);
+            ofPushStyle();
+              ofSetColor(ofColor::green);
+              ofSetLineWidth(3);
+              for (auto &blob : frame.blobs) {
+                blob.contour.draw();
+                ofDrawBitmapStringHighlight(ofToString(blob.label) + " : " + ofToString(blob.age), blob.centroid);
+              }
+
+              // Where the mask was refined, if not everywhere.
+              ofNoFill();
+              ofSetColor(ofColor::yellow);
+              ofSetLineWidth(1);
+              for (auto &r : frame.regions) {
+                ofDrawRectangle(r);
+              }
+            ofPopStyle();
+          ofPopMatrix();
+        }
       
         // Draw the X line and Y line at the center of the depth pixels
         ofPushStyle();
@@ -118,12 +169,37 @@ void Kinect::initialize() {
   contourParams.add(minArea.set("Min Area", 10, 1, 100));
   contourParams.add(maxArea.set("Max Area", 200, 1, 500));
   contourParams.add(contourThreshold.set("Threshold", 128, 0, 255));
+
+  // Where the full resolution mask is made.
+  regionParams.setName("Regions");
+  regionParams.add(pyramidLevel.set("Pyramid Level", 2, 0, 4));
+  regionParams.add(rescanInterval.set("Rescan Interval", 30, 0, 300));
+  regionParams.add(regionPadding.set("Padding", 10, 0, 50));
+
+  // What's in the room when nobody is.
+  backgroundParams.setName("Background");
+  backgroundParams.add(background.set("Subtract Background", false));
+  backgroundParams.add(backgroundThreshold.set("Threshold (mm)", 150, 0, 1000));
+  backgroundParams.add(backgroundRate.set("Learning Rate", 0.05, 0, 1));
+  backgroundParams.add(backgroundInterval.set("Learning Interval", 15, 1, 300));
+
+  // Latency compensation.
+  trackingParams.setName("Tracking");
+  trackingParams.add(prediction.set("Prediction", true));
+  trackingParams.add(velocitySmoothing.set("Velocity Smoothing", 0.5, 0, 0.95));
+  trackingParams.add(maxLead.set("Max Lead (ms)", 100, 0, 500));
+  trackingParams.add(silhouettes.set("Silhouettes", true));
+  trackingParams.add(occupancyCell.set("Occupancy Cell (px)", 20, 5, 100));
+  trackingParams.add(mergeDistance.set("Merge Distance (px)", 80, 0, 300));
   
   // Open Kinect
   kinect.params.setName("Distance Thresholds");
   settings.add(kinect.params);
   settings.add(imageParams);
   settings.add(contourParams);
+  settings.add(regionParams);
+  settings.add(backgroundParams);
+  settings.add(trackingParams);
   gui.setup(settings);
   
   gui.setPosition(250, 20);
@@ -131,35 +207,160 @@ void Kinect::initialize() {
   gui.loadFromFile("Kinect.xml");
 }
 
-std::vector<glm::vec2> Kinect::getBodyCentroids() {
-  std::vector<glm::vec2> centroids;
+void Kinect::updateAudience() {
+  audience.time = ofGetElapsedTimeMicros();
+  audience.timestamp = audience.time;
+  audience.processingTime = 0;
+  audience.frameIdx = 0;
+  audience.points.clear();
+  audience.ids.clear();
+  audience.sources.clear();
+  if (silhouettes) {
+    audience.occupancy.setup(ofGetWidth(), ofGetHeight(), occupancyCell);
+  } else {
+    audience.occupancy = OccupancyGrid();
+  }
   
-  // Master matrix
-  ofMatrix4x4 scaleMatrix = ofMatrix4x4::newScaleMatrix(ofVec3f(scaleVariables.x, scaleVariables.y, 0));
-  for (int i = 0; i < contourFinder.size(); i++) {
-    auto center = ofxCv::toOf(contourFinder.getCenter(i));
-    auto newPoint = ofVec3f(center.x, center.y, 0) * scaleMatrix;
-    centroids.push_back(glm::vec2(newPoint.x, newPoint.y));
+  for (int i = 0; i < sources.size(); i++) {
+    auto &source = *sources[i];
+    auto &frame = source.getFrame();
+    // As old as the oldest source.
+    if (frame.timestamp > 0) {
+      audience.timestamp = std::min(audience.timestamp, frame.timestamp);
+    }
+    audience.processingTime = std::max(audience.processingTime, frame.processingTime);
+    audience.frameIdx = std::max(audience.frameIdx, frame.frameIdx);
+  
+    for (auto &blob : frame.blobs) {
+      auto center = prediction ? AudienceTracker::predict(blob, frame.timestamp, audience.time, maxLead * 1000) : blob.centroid;
+      audience.points.push_back(source.toScreen(center));
+      audience.ids.push_back(i << 24 | blob.label);
+      audience.sources.push_back(i);
+    
+      // The contour moves along with the prediction.
+      if (silhouettes) {
+        auto offset = center - blob.centroid;
+        silhouette.clear();
+        for (auto &p : blob.contour) {
+          silhouette.push_back(source.toScreen(glm::vec2(p.x, p.y) + offset));
+        }
+        audience.occupancy.addPolygon(silhouette);
+      }
+    }
   }
   
-  return centroids;
+  // Where the sources overlap, people are seen twice.
+  if (sources.size() > 1) {
+    audience.mergeDuplicates(mergeDistance);
+  }
+  if (silhouettes) {
+    audience.occupancy.build();
+  }
 }
 
-void Kinect::drawContent() {
-  ofPushMatrix();
-    ofScale(scaleVariables.x, scaleVariables.y);
-      // Draw circle where the center of the contour is (to track position)
-      for (int i = 0; i < contourFinder.size(); i++) {
-        ofPushMatrix();
-          auto center = ofxCv::toOf(contourFinder.getCenter(i));
-          ofTranslate(center);
-          ofPushStyle();
-            ofSetColor(ofColor::green);
-            ofDrawCircle(0, 0, 3);
-          ofPopStyle();
-        ofPopMatrix();
+void Kinect::toggleCalibration() {
+  if (!kinectOpen) {
+    return;
+  }
+  isCalibrating = !isCalibrating;
+  if (isCalibrating) {
+    // Start from no points, the saved calibration maps the audience until the new one is fit.
+    for (auto &source : sources) {
+      source->calibration.clearPairs();
+    }
+    calibrationOrder.clear();
+    ofLog() << "Calibrating the Kinect. Click where the person is, right click to undo." << endl;
+    return;
+  }
+  
+  for (auto &source : sources) {
+    auto &calibration = source->calibration;
+    if (calibration.getPairs().empty()) {
+      ofLog() << "No new points for " << source->name << ", keeping its calibration." << endl;
+    } else if (calibration.fit()) {
+      calibration.save(source->name + "Calibration.json");
+      ofLog() << "Saved the " << source->name << " calibration from " << calibration.getPairs().size() << " points." << endl;
+    } else {
+      ofLogWarning("Kinect") << source->name << " calibration needs 4 points or more, keeping the previous one.";
+    }
+  }
+}
+
+void Kinect::addCalibrationPoint(glm::vec2 screen) {
+  // Whoever looks closest with the mapping we have, in any of the sources.
+  KinectSource *nearestSource = NULL;
+  const PeopleBlob *nearest = NULL;
+  float nearestDistance = std::numeric_limits<float>::max();
+  for (auto &source : sources) {
+    for (auto &blob : source->getFrame().blobs) {
+      auto distance = glm::distance(source->toScreen(blob.centroid), screen);
+      if (distance < nearestDistance) {
+        nearestSource = source.get(); nearest = &blob; nearestDistance = distance;
       }
-  ofPopMatrix();
+    }
+  }
+  if (nearest == NULL) {
+    ofLogWarning("Kinect") << "Nobody to calibrate with.";
+    return;
+  }
+  nearestSource->calibration.addPair(nearest->centroid, screen / glm::vec2(ofGetWidth(), ofGetHeight()));
+  calibrationOrder.push_back(nearestSource);
+}
+
+void Kinect::removeCalibrationPoint() {
+  if (calibrationOrder.size() > 0) {
+    calibrationOrder.back()->calibration.removeLastPair();
+    calibrationOrder.pop_back();
+  }
+}
+
+void Kinect::drawCalibration() {
+  ofPushStyle();
+    for (auto &source : sources) {
+      // People where the mapping puts them now.
+      ofSetColor(ofColor::green);
+      for (auto &blob : source->getFrame().blobs) {
+        ofDrawCircle(source->toScreen(blob.centroid), 10);
+      }
+    
+      // The points so far, and how far off the mapping has them.
+      for (auto &p : source->calibration.getPairs()) {
+        auto screen = p.screen * glm::vec2(ofGetWidth(), ofGetHeight());
+        ofSetColor(ofColor::yellow);
+        ofDrawLine(screen - glm::vec2(10, 0), screen + glm::vec2(10, 0));
+        ofDrawLine(screen - glm::vec2(0, 10), screen + glm::vec2(0, 10));
+        ofSetColor(ofColor::red);
+        ofDrawLine(screen, source->toScreen(p.depth));
+      }
+    }
+  ofPopStyle();
+  
+  std::string points;
+  for (auto &source : sources) {
+    points += " " + source->name + ": " + ofToString(source->calibration.getPairs().size());
+  }
+  ofDrawBitmapStringHighlight("Calibration points" + points + ". Click where the person is, right click to undo, 'a' to finish.", 20, ofGetHeight() - 20);
+}
+
+void Kinect::drawContent() {
+  // Draw circle where the center of the contour is (to track position)
+  auto now = ofGetElapsedTimeMicros();
+  for (auto &source : sources) {
+    auto &frame = source->getFrame();
+    for (auto &blob : frame.blobs) {
+      auto center = source->toScreen(blob.centroid);
+      ofPushStyle();
+        ofSetColor(ofColor::green);
+        ofDrawCircle(center, 3);
+      
+        // And where they're predicted to be now.
+        if (prediction) {
+          ofSetColor(ofColor::cyan);
+          ofDrawLine(center, source->toScreen(AudienceTracker::predict(blob, frame.timestamp, now, maxLead * 1000)));
+        }
+      ofPopStyle();
+    }
+  }
 }
 
 void Kinect::drawTextureAtRowAndColumn(const std::string& title,
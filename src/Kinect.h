@@ -4,26 +4,54 @@
 #include "ofxKinectV2.h"
 #include "ofxCv.h"
 #include "ofxGui.h"
+#include "AudienceFrame.h"
+#include "KinectSource.h"
 
 class Kinect {
   public:
     void setup();
     void update();
     void draw();
-    std::vector<glm::vec2> getBodyCentroids(); // TODO: This should be a vector
+    void exit();
+    // Where the people are now (screen), predicted from the last depth frame. Made once
+    // every update.
+    const AudienceFrame &getAudience() const { return audience; }
+  
+    // Record the raw depth frames of every Kinect to data/<name>_<time>.depth. Rename
+    // them to Kinect.depth, Kinect1.depth... and they're replayed (in a loop) whenever
+    // there's no Kinect.
+    void toggleRecording();
+
+    // Calibration mode: stand somewhere and click where you are on the screen, at 4 or
+    // more places around the floor seen by each Kinect. Leaving it fits every Kinect's
+    // depth to screen mapping and saves it to data/<name>Calibration.json. Without one,
+    // the depth image is just stretched over the screen.
+    void toggleCalibration();
+    void addCalibrationPoint(glm::vec2 screen); // Pairs it with the person nearest to it.
+    void removeCalibrationPoint();
+    void drawCalibration();
+    bool isCalibrating = false;
   
     // Flags
-    bool kinectOpen;
+    bool kinectOpen; // Live or replayed frames, from one source or more.
+    bool isReplay;
   
     // Kinect Gui.
     ofxPanel gui;
   
   private:
-    ofxKinectV2 kinect;
+    // Every Kinect (Kinect, Kinect1, Kinect2...), or the recordings in their place.
+    std::vector<std::unique_ptr<KinectSource>> sources;
+    static std::string getSourceName(int idx);
+    std::vector<KinectSource *> calibrationOrder; // Where every calibration point went, for undo.
+    ofxKinectV2 kinect; // Never opened, it's the GUI's distance thresholds and exposure.
   
     // Helper methods.
     void drawContent();
+    void updateAudience();
+    std::vector<glm::vec2> silhouette; // Scratch, one contour on the screen.
     void initialize();
+    DepthSettings getSettings();
     void drawTextureAtRowAndColumn(const std::string& title,
                                    const ofTexture& tex,
                                    int row, int column,
@@ -44,13 +72,32 @@ class Kinect {
     ofParameter<float> maxArea;
     ofParameter<int> contourThreshold;
 
-    // Kinect working textures.
+    // Pyramid level and region params.
+    ofParameterGroup regionParams;
+    ofParameter<int> pyramidLevel;
+    ofParameter<int> rescanInterval;
+    ofParameter<int> regionPadding;
+
+    // Background params.
+    ofParameterGroup backgroundParams;
+    ofParameter<bool> background;
+    ofParameter<float> backgroundThreshold;
+    ofParameter<float> backgroundRate;
+    ofParameter<int> backgroundInterval;
+
+    // Tracking params.
+    ofParameterGroup trackingParams;
+    ofParameter<bool> prediction;
+    ofParameter<float> velocitySmoothing;
+    ofParameter<int> maxLead;
+    ofParameter<bool> silhouettes;
+    ofParameter<int> occupancyCell;
+    ofParameter<float> mergeDistance;
+
+    // Kinect debug textures. Only loaded when they're drawn.
     ofTexture texRGB;
     ofTexture texRGBRegistered;
     ofTexture texIR;
-    ofTexture texDepth;
   
-    // Contour Finding.
-    ofxCv::ContourFinder contourFinder;
-    glm::vec2 scaleVariables;
+    AudienceFrame audience;
 };
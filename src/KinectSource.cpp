@@ -0,0 +1,108 @@
+#include "KinectSource.h"
+
+KinectSource::~KinectSource() {
+  close();
+}
+
+bool KinectSource::openDevice(std::string serial, std::string n) {
+  name = n;
+  if (!device.open(serial)) {
+    return false;
+  }
+  calibration.load(name + "Calibration.json");
+  pipeline.start();
+  isOpen = true;
+  return true;
+}
+
+bool KinectSource::openReplay(std::string path, std::string n) {
+  name = n;
+  isReplay = replay.load(path);
+  if (!isReplay) {
+    return false;
+  }
+  replayStartTime = ofGetElapsedTimeMicros();
+  replayIdx = -1;
+  calibration.load(name + "Calibration.json");
+  pipeline.start();
+  isOpen = true;
+  return true;
+}
+
+void KinectSource::close() {
+  if (!isOpen) {
+    return;
+  }
+  isOpen = false;
+  pipeline.stop(); // Before the replay goes, its frames are in the pipeline.
+  recorder.stop();
+  replay.close();
+  if (!isReplay) {
+    device.close();
+  }
+}
+
+void KinectSource::update(const DepthSettings &settings) {
+  if (isReplay) {
+    updateReplay(settings);
+  } else {
+    // Update Kinect to process next frame. The device is read on libfreenect2's thread,
+    // this only swaps its buffers (and isFrameNew goes by the app frame), so it stays here.
+    device.update();
+    
+    // Hand new frames to the pipeline.
+    if (device.isFrameNew()) {
+      auto &raw = device.getRawDepthPixels();
+      auto &depth = depthFrame.depth;
+      if (depth.getWidth() != raw.getWidth() || depth.getHeight() != raw.getHeight()) {
+        depth.allocate(raw.getWidth(), raw.getHeight(), OF_PIXELS_GRAY);
+      }
+      auto src = raw.getData(); auto dst = depth.getData();
+      for (size_t i = 0; i < depth.size(); i++) {
+        dst[i] = ofClamp(src[i] + 0.5f, 0, 65535); // mm
+      }
+      depthFrame.timestamp = ofGetElapsedTimeMicros();
+      
+      recorder.write(depthFrame); // Copied, the recorder writes it on its own thread.
+      pipeline.setSettings(settings);
+      pipeline.push(depthFrame);
+    }
+  }
+
+  // Latest people the pipeline found.
+  pipeline.update();
+}
+
+void KinectSource::updateReplay(const DepthSettings &settings) {
+  // Play the frames at the pace they were recorded at, in a loop.
+  auto now = ofGetElapsedTimeMicros();
+  auto elapsed = (now - replayStartTime) % (replay.getDuration() + 1);
+  int idx = replay.getFrameIdx(elapsed);
+  if (idx != replayIdx) {
+    replayIdx = idx;
+    replay.getFrame(idx, depthFrame);
+    depthFrame.timestamp = now; // Captured now as far as everybody else knows.
+    pipeline.setSettings(settings);
+    pipeline.push(depthFrame);
+  }
+}
+
+glm::vec2 KinectSource::toScreen(glm::vec2 depth) const {
+  if (calibration.isCalibrated()) {
+    return calibration.map(depth) * glm::vec2(ofGetWidth(), ofGetHeight());
+  }
+  // To fit the contours on top of the entire screen, we calculate scale.
+  auto &pixels = getFrame().depth;
+  if (!pixels.isAllocated()) {
+    return depth;
+  }
+  return depth * glm::vec2(ofGetWidth() / (float) pixels.getWidth(), ofGetHeight() / (float) pixels.getHeight());
+}
+
+void KinectSource::toggleRecording() {
+  if (recorder.isRecording()) {
+    recorder.stop();
+  } else if (!isReplay) {
+    recorder.start(name + "_" + ofGetTimestampString() + ".depth");
+  }
+}
@@ -0,0 +1,47 @@
+// One depth sensor of the Kinect front end: a live Kinect, or a recording replayed in
+// its place. Every source runs its own DepthPipeline thread, so a busy one never holds
+// up the others, and maps its people to the screen with its own calibration.
+#pragma once
+#include "ofMain.h"
+#include "ofxKinectV2.h"
+#include "DepthCalibration.h"
+#include "DepthPipeline.h"
+#include "DepthRecording.h"
+
+class KinectSource {
+  public:
+    ~KinectSource();
+
+    // name: what its files are called, <name>Calibration.json and <name>_<time>.depth.
+    bool openDevice(std::string serial, std::string name);
+    bool openReplay(std::string path, std::string name); // Plays it in a loop.
+    void close();
+
+    // Main thread. Hands the newest frame to the pipeline and picks up the latest people.
+    void update(const DepthSettings &settings);
+    const PeopleFrame &getFrame() const { return pipeline.getFrame(); }
+
+    // Depth image to screen. Without a calibration the depth image is stretched over it.
+    glm::vec2 toScreen(glm::vec2 depth) const;
+
+    void toggleRecording();
+    bool isRecording() { return recorder.isRecording(); }
+
+    std::string name;
+    bool isReplay = false;
+    ofxKinectV2 device; // Live only.
+    DepthCalibration calibration;
+    ofTexture texDepth; // Debug, only loaded when it's drawn.
+
+  private:
+    DepthPipeline pipeline;
+    DepthFrame depthFrame; // Next frame to push.
+
+    // Recording and replay.
+    void updateReplay(const DepthSettings &settings);
+    DepthRecorder recorder;
+    DepthReplay replay;
+    uint64_t replayStartTime = 0;
+    int replayIdx = -1;
+    bool isOpen = false;
+};
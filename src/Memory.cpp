@@ -29,16 +29,11 @@ void Memory::update() {
   }
 }
 
-void Memory::draw() {
-  ofPushMatrix();
-    ofTranslate(mem->getPosition());
-    ofPushStyle();
-      color = color.lerp(finalColor, 0.5);
-      auto opacity = ofMap(elapsedTime, 0, maxTime, 200, 50, true);
-      ofSetColor(color, opacity);
-      ofDrawCircle(0, 0, mem->getRadius());
-    ofPopStyle();
-  ofPopMatrix();
+MemorySnapshot Memory::getSnapshot() {
+  color = color.lerp(finalColor, 0.5);
+  auto opacity = ofMap(elapsedTime, 0, maxTime, 200, 50, true);
+  glm::vec2 pos = mem->getPosition();
+  return { pos, mem->getRadius(), ofColor(color, opacity) };
 }
 
 void Memory::destroy() {
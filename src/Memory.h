@@ -3,11 +3,18 @@
 #include "ofMain.h"
 #include "ofxBox2d.h"
 
+// How a memory looks right now.
+struct MemorySnapshot {
+  glm::vec2 position;
+  float radius;
+  ofColor color; // Alpha is the opacity.
+};
+
 class Memory {
   public:
     Memory(ofxBox2d &box2d, glm::vec2 location, bool isAgent = false);
     void update();
-    void draw();
+    MemorySnapshot getSnapshot();
     void destroy();
     bool shouldRemove;
     ofColor finalColor;
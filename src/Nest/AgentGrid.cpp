@@ -0,0 +1,123 @@
+#include "AgentGrid.h"
+
+void AgentGrid::setup(float w, float h) {
+  width = w;
+  height = h;
+  cellSize = 1;
+  numCols = 0;
+  numRows = 0;
+}
+
+void AgentGrid::clear() {
+  circles.clear();
+}
+
+void AgentGrid::add(int idx, glm::vec2 center, float radius) {
+  circles.push_back({ idx, center, radius });
+}
+
+void AgentGrid::build() {
+  // Size the cells after the biggest circle.
+  float maxRadius = 1;
+  for (auto &c : circles) {
+    maxRadius = std::max(maxRadius, c.radius);
+  }
+  cellSize = maxRadius * 2;
+  numCols = std::max(1, (int) ceil(width / cellSize));
+  numRows = std::max(1, (int) ceil(height / cellSize));
+  
+  // Counting sort of the circles into the cells they overlap.
+  // Pass 1: count the entries of every cell.
+  cellStart.assign(numCols * numRows + 1, 0);
+  for (auto &c : circles) {
+    int x0 = getCellX(c.center.x - c.radius); int x1 = getCellX(c.center.x + c.radius);
+    int y0 = getCellY(c.center.y - c.radius); int y1 = getCellY(c.center.y + c.radius);
+    for (int y = y0; y <= y1; y++) {
+      for (int x = x0; x <= x1; x++) {
+        cellStart[y * numCols + x + 1]++;
+      }
+    }
+  }
+  
+  // Pass 2: prefix sum to get where every cell starts.
+  for (int i = 1; i < cellStart.size(); i++) {
+    cellStart[i] += cellStart[i - 1];
+  }
+  
+  // Pass 3: fill the entries.
+  entries.resize(cellStart.back());
+  cellCursor.assign(cellStart.begin(), cellStart.end() - 1);
+  for (int i = 0; i < circles.size(); i++) {
+    auto &c = circles[i];
+    int x0 = getCellX(c.center.x - c.radius); int x1 = getCellX(c.center.x + c.radius);
+    int y0 = getCellY(c.center.y - c.radius); int y1 = getCellY(c.center.y + c.radius);
+    for (int y = y0; y <= y1; y++) {
+      for (int x = x0; x <= x1; x++) {
+        entries[cellCursor[y * numCols + x]++] = i;
+      }
+    }
+  }
+}
+
+void AgentGrid::getVisible(glm::vec2 p, std::vector<int> &result) const {
+  result.clear();
+  if (numCols == 0) {
+    return;
+  }
+  
+  int cell = getCellY(p.y) * numCols + getCellX(p.x);
+  for (int e = cellStart[cell]; e < cellStart[cell + 1]; e++) {
+    auto &c = circles[entries[e]];
+    auto d = glm::distance(c.center, p);
+    if (d <= c.radius) {
+      result.push_back(c.idx);
+    }
+  }
+}
+
+int AgentGrid::getClosest(glm::vec2 p) const {
+  if (numCols == 0 || circles.size() == 0) {
+    return -1;
+  }
+  
+  // Search rings of cells around the point. A circle is always in the cell of its
+  // own center, so once the best distance is inside the searched rings we're done.
+  int px = getCellX(p.x); int py = getCellY(p.y);
+  float minD = std::numeric_limits<float>::max();
+  int minIdx = -1;
+  int maxRing = std::max(numCols, numRows);
+  for (int ring = 0; ring <= maxRing; ring++) {
+    for (int y = py - ring; y <= py + ring; y++) {
+      if (y < 0 || y >= numRows) continue;
+      for (int x = px - ring; x <= px + ring; x++) {
+        if (x < 0 || x >= numCols) continue;
+        // Only the outline of the ring, the inside is already searched.
+        if (abs(x - px) != ring && abs(y - py) != ring) continue;
+        
+        int cell = y * numCols + x;
+        for (int e = cellStart[cell]; e < cellStart[cell + 1]; e++) {
+          auto &c = circles[entries[e]];
+          auto d = glm::distance(c.center, p);
+          if (d < minD) {
+            minD = d;
+            minIdx = c.idx;
+          }
+        }
+      }
+    }
+    
+    if (minIdx >= 0 && minD <= ring * cellSize) {
+      break;
+    }
+  }
+  
+  return minIdx;
+}
+
+int AgentGrid::getCellX(float x) const {
+  return ofClamp(floor(x / cellSize), 0, numCols - 1);
+}
+
+int AgentGrid::getCellY(float y) const {
+  return ofClamp(floor(y / cellSize), 0, numRows - 1);
+}
@@ -0,0 +1,46 @@
+// Uniform grid of agent reach circles (centroid, visibilityRadius + audienceVisibilityRadius).
+// It's rebuilt once per frame and answers "which agents can see this person?" by looking at
+// a single cell instead of measuring the distance to every agent.
+#pragma once
+#include "ofMain.h"
+
+class AgentGrid {
+  public:
+    void setup(float width, float height);
+
+    // Rebuild the grid with all the circles of this frame. The cell size follows
+    // the largest circle so every circle overlaps at most 2x2 cells.
+    void clear();
+    void add(int idx, glm::vec2 center, float radius);
+    void build();
+
+    // Indices of all the circles that contain the point.
+    void getVisible(glm::vec2 p, std::vector<int> &result) const;
+    // Index of the circle whose center is closest to the point (-1 if empty).
+    int getClosest(glm::vec2 p) const;
+
+    float getCellSize() const { return cellSize; }
+
+  private:
+    struct Circle {
+      int idx;
+      glm::vec2 center;
+      float radius;
+    };
+
+    int getCellX(float x) const;
+    int getCellY(float y) const;
+
+    float width;
+    float height;
+    float cellSize;
+    int numCols;
+    int numRows;
+
+    // Circles added this frame.
+    std::vector<Circle> circles;
+    // Cells are stored flat: cell i owns entries[cellStart[i] .. cellStart[i+1]).
+    std::vector<int> cellStart;
+    std::vector<int> entries; // Index into circles.
+    std::vector<int> cellCursor; // Scratch while filling the entries.
+};
@@ -0,0 +1,204 @@
+#include "BondRegistry.h"
+
+static const uint64_t emptyKey = std::numeric_limits<uint64_t>::max();
+
+BondRegistry::BondRegistry() {
+  keys.assign(64, emptyKey);
+  values.assign(64, -1);
+  numEntries = 0;
+}
+
+uint64_t BondRegistry::getKey(Agent *agentA, Agent *agentB) {
+  uint64_t idA = agentA->id; uint64_t idB = agentB->id;
+  return idA < idB ? (idA << 32) | idB : (idB << 32) | idA;
+}
+
+uint64_t BondRegistry::hash(uint64_t key) {
+  // splitmix64 finalizer, ids are sequential so they need mixing.
+  key ^= key >> 30; key *= 0xbf58476d1ce4e5b9ULL;
+  key ^= key >> 27; key *= 0x94d049bb133111ebULL;
+  key ^= key >> 31;
+  return key;
+}
+
+BondHandle BondRegistry::add(Agent *agentA, Agent *agentB, std::shared_ptr<ofxBox2dJoint> joint) {
+  auto key = getKey(agentA, agentB);
+  if (findEntry(key) >= 0) {
+    ofLogWarning("BondRegistry") << "Agents " << agentA->id << " and " << agentB->id << " are already bonded.";
+    return find(agentA, agentB);
+  }
+
+  // Reuse a free slot if there is one.
+  int slotIdx;
+  if (freeSlots.size() > 0) {
+    slotIdx = freeSlots.back();
+    freeSlots.pop_back();
+  } else {
+    slotIdx = slots.size();
+    slots.push_back(Slot());
+  }
+
+  auto &slot = slots[slotIdx];
+  slot.bond = SuperAgent();
+  slot.bond.setup(agentA, agentB, joint);
+  slot.key = key;
+  slot.activeIdx = active.size();
+
+  BondHandle handle { slotIdx, slot.generation };
+  active.push_back(handle);
+  insertEntry(key, slotIdx);
+  adjacency[agentA->id].push_back(handle);
+  adjacency[agentB->id].push_back(handle);
+  return handle;
+}
+
+BondHandle BondRegistry::find(Agent *agentA, Agent *agentB) const {
+  auto entry = findEntry(getKey(agentA, agentB));
+  if (entry < 0) {
+    return BondHandle();
+  }
+  auto slotIdx = values[entry];
+  return BondHandle { slotIdx, slots[slotIdx].generation };
+}
+
+void BondRegistry::remove(BondHandle handle) {
+  if (!isValid(handle)) {
+    return;
+  }
+
+  auto &slot = slots[handle.slot];
+  removeAdjacency(slot.bond.agentA, handle);
+  removeAdjacency(slot.bond.agentB, handle);
+  eraseEntry(findEntry(slot.key));
+
+  // Swap remove from the active list.
+  auto last = active.back();
+  active[slot.activeIdx] = last;
+  slots[last.slot].activeIdx = slot.activeIdx;
+  active.pop_back();
+
+  slot.bond = SuperAgent(); // Let go of the joints.
+  slot.activeIdx = -1;
+  slot.generation++; // Old handles are invalid now.
+  freeSlots.push_back(handle.slot);
+}
+
+void BondRegistry::clear() {
+  for (auto &slot : slots) {
+    if (slot.activeIdx >= 0) {
+      slot.generation++;
+    }
+    slot.bond = SuperAgent();
+    slot.activeIdx = -1;
+  }
+  freeSlots.clear();
+  for (int i = slots.size() - 1; i >= 0; i--) {
+    freeSlots.push_back(i);
+  }
+  active.clear();
+  std::fill(keys.begin(), keys.end(), emptyKey);
+  numEntries = 0;
+  adjacency.clear();
+}
+
+bool BondRegistry::isValid(BondHandle handle) const {
+  return handle.slot >= 0 && handle.slot < slots.size()
+    && slots[handle.slot].generation == handle.generation
+    && slots[handle.slot].activeIdx >= 0;
+}
+
+SuperAgent *BondRegistry::get(BondHandle handle) {
+  return isValid(handle) ? &slots[handle.slot].bond : NULL;
+}
+
+const std::vector<BondHandle> &BondRegistry::getBonds(Agent *agent) const {
+  auto it = adjacency.find(agent->id);
+  return it == adjacency.end() ? noBonds : it->second;
+}
+
+void BondRegistry::removeAdjacency(Agent *agent, BondHandle handle) {
+  auto it = adjacency.find(agent->id);
+  if (it == adjacency.end()) {
+    return;
+  }
+
+  auto &bonds = it->second;
+  ofRemove(bonds, [&](BondHandle &h) {
+    return h.slot == handle.slot && h.generation == handle.generation;
+  });
+  if (bonds.empty()) {
+    adjacency.erase(it);
+  }
+}
+
+// ------------------------------ Hash table --------------------------------------- //
+
+int BondRegistry::findEntry(uint64_t key) const {
+  auto mask = keys.size() - 1;
+  auto i = hash(key) & mask;
+  while (keys[i] != emptyKey) {
+    if (keys[i] == key) {
+      return i;
+    }
+    i = (i + 1) & mask;
+  }
+  return -1;
+}
+
+void BondRegistry::insertEntry(uint64_t key, int slot) {
+  // Keep the table at most half full so the probes stay short.
+  if ((numEntries + 1) * 2 > keys.size()) {
+    grow();
+  }
+
+  auto mask = keys.size() - 1;
+  auto i = hash(key) & mask;
+  while (keys[i] != emptyKey) {
+    i = (i + 1) & mask;
+  }
+  keys[i] = key;
+  values[i] = slot;
+  numEntries++;
+}
+
+void BondRegistry::eraseEntry(int entry) {
+  if (entry < 0) {
+    return;
+  }
+
+  // Shift the following entries back instead of leaving a tombstone.
+  auto mask = keys.size() - 1;
+  size_t i = entry; size_t j = entry;
+  while (true) {
+    keys[i] = emptyKey;
+    while (true) {
+      j = (j + 1) & mask;
+      if (keys[j] == emptyKey) {
+        numEntries--;
+        return;
+      }
+      // The entry at j can stay if its home is cyclically in (i, j].
+      auto home = hash(keys[j]) & mask;
+      bool stays = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+      if (!stays) {
+        break;
+      }
+    }
+    keys[i] = keys[j];
+    values[i] = values[j];
+    i = j;
+  }
+}
+
+void BondRegistry::grow() {
+  auto oldKeys = keys;
+  auto oldValues = values;
+  keys.assign(oldKeys.size() * 2, emptyKey);
+  values.assign(oldValues.size() * 2, -1);
+  numEntries = 0;
+  for (int i = 0; i < oldKeys.size(); i++) {
+    if (oldKeys[i] != emptyKey) {
+      insertEntry(oldKeys[i], oldValues[i]);
+    }
+  }
+}
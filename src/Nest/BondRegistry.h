@@ -0,0 +1,63 @@
+// All the bonds (SuperAgents) in the nest. A bond is found by the pair of agents it
+// connects through an open addressing hash table, and every agent keeps the list of
+// its bonds, so nothing has to scan all the pairs.
+// Handles stay valid until the bond is removed. Pointers from get() only until the next add().
+#pragma once
+#include "ofMain.h"
+#include "SuperAgent.h"
+
+struct BondHandle {
+  int slot = -1;
+  int generation = 0;
+};
+
+class BondRegistry {
+  public:
+    BondRegistry();
+
+    // Key of a pair of agents, same for (a, b) and (b, a).
+    static uint64_t getKey(Agent *agentA, Agent *agentB);
+
+    BondHandle add(Agent *agentA, Agent *agentB, std::shared_ptr<ofxBox2dJoint> joint);
+    BondHandle find(Agent *agentA, Agent *agentB) const;
+    void remove(BondHandle handle);
+    void clear();
+
+    bool isValid(BondHandle handle) const;
+    SuperAgent *get(BondHandle handle);
+
+    // Bonds of one agent.
+    const std::vector<BondHandle> &getBonds(Agent *agent) const;
+
+    // Every bond currently in the nest.
+    const std::vector<BondHandle> &getHandles() const { return active; }
+    int size() const { return active.size(); }
+
+  private:
+    struct Slot {
+      SuperAgent bond;
+      uint64_t key;
+      int generation = 0;
+      int activeIdx = -1; // Position in active, -1 when the slot is free.
+    };
+
+    // Hash table: key -> slot, linear probing.
+    int findEntry(uint64_t key) const;
+    void insertEntry(uint64_t key, int slot);
+    void eraseEntry(int entry);
+    void grow();
+    static uint64_t hash(uint64_t key);
+
+    void removeAdjacency(Agent *agent, BondHandle handle);
+
+    std::vector<Slot> slots;
+    std::vector<int> freeSlots;
+    std::vector<BondHandle> active;
+
+    std::vector<uint64_t> keys; // emptyKey for unused entries.
+    std::vector<int> values;
+    int numEntries;
+
+    std::unordered_map<int, std::vector<BondHandle>> adjacency; // Agent id -> bonds.
+    std::vector<BondHandle> noBonds;
+};
@@ -0,0 +1,35 @@
+#include "ContactQueue.h"
+
+void ContactQueue::setup(int capacity) {
+  contacts.clear();
+  contacts.reserve(capacity);
+  isRecording = false;
+}
+
+void ContactQueue::beginStep() {
+  isRecording = true;
+}
+
+void ContactQueue::endStep() {
+  isRecording = false;
+}
+
+void ContactQueue::push(ofxBox2dContactArgs &e, bool isStart) {
+  if (!isRecording || e.a == NULL || e.b == NULL) {
+    return;
+  }
+
+  // Only vertices (circles) take part in the interaction.
+  if (e.a->GetType() != b2Shape::e_circle || e.b->GetType() != b2Shape::e_circle) {
+    return;
+  }
+
+  auto bodyA = e.a->GetBody(); auto bodyB = e.b->GetBody();
+  if (bodyA && bodyB) {
+    contacts.push_back({ bodyA, bodyB, isStart });
+  }
+}
+
+void ContactQueue::clear() {
+  contacts.clear(); // Keeps the capacity.
+}
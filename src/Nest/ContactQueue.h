@@ -0,0 +1,29 @@
+// Contacts reported by box2d while it steps. The callbacks only record the two bodies;
+// Nest drains the queue after box2d.update(), when it's safe to touch the world.
+// Anything reported outside a step (bodies being destroyed) is ignored.
+#pragma once
+#include "ofMain.h"
+#include "ofxBox2d.h"
+
+struct Contact {
+  b2Body *bodyA;
+  b2Body *bodyB;
+  bool isStart; // Start or end of the contact.
+};
+
+class ContactQueue {
+  public:
+    void setup(int capacity);
+
+    // Recording is only on during the step.
+    void beginStep();
+    void endStep();
+    void push(ofxBox2dContactArgs &e, bool isStart);
+
+    const std::vector<Contact> &getContacts() const { return contacts; }
+    void clear();
+
+  private:
+    std::vector<Contact> contacts;
+    bool isRecording = false;
+};
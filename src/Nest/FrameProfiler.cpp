@@ -0,0 +1,57 @@
+#include "FrameProfiler.h"
+
+FrameProfiler::FrameProfiler() {
+  for (int i = 0; i < NumPhases; i++) {
+    times[i] = 0;
+    lastTimes[i] = 0;
+    averages[i] = 0;
+  }
+}
+
+void FrameProfiler::beginFrame() {
+  for (int i = 0; i < NumPhases; i++) {
+    lastTimes[i] = times[i];
+    averages[i] = ofLerp(averages[i], times[i], 0.05);
+    times[i] = 0;
+  }
+}
+
+void FrameProfiler::begin(NestPhase phase) {
+  startTimes[phase] = std::chrono::steady_clock::now();
+}
+
+void FrameProfiler::end(NestPhase phase) {
+  auto elapsed = std::chrono::steady_clock::now() - startTimes[phase];
+  times[phase] += std::chrono::duration<float, std::milli>(elapsed).count();
+}
+
+float FrameProfiler::getTime(NestPhase phase) const {
+  return lastTimes[phase];
+}
+
+float FrameProfiler::getAverage(NestPhase phase) const {
+  return averages[phase];
+}
+
+std::string FrameProfiler::getName(NestPhase phase) {
+  switch (phase) {
+    case Input: return "Input";
+    case Physics: return "Physics";
+    case MeshSync: return "Mesh Sync";
+    case Behaviors: return "Behaviors";
+    case Bonding: return "Bonding";
+    case Lifecycle: return "Lifecycle";
+    case Memories: return "Memories";
+    case Render: return "Render";
+    default: return "";
+  }
+}
+
+std::string FrameProfiler::toString() const {
+  std::stringstream ss;
+  for (int i = 0; i < NumPhases; i++) {
+    auto phase = (NestPhase) i;
+    ss << getName(phase) << ": " << ofToString(getAverage(phase), 3) << " ms" << endl;
+  }
+  return ss.str();
+}
@@ -0,0 +1,38 @@
+// Wall clock time of every phase of a frame, so we can see where the 16.6 ms go.
+// A phase can run more than once in a frame (physics sub-steps), its time adds up.
+#pragma once
+#include "ofMain.h"
+
+enum NestPhase {
+  Input,
+  Physics,
+  MeshSync,
+  Behaviors,
+  Bonding,
+  Lifecycle,
+  Memories,
+  Render,
+  NumPhases
+};
+
+class FrameProfiler {
+  public:
+    FrameProfiler();
+    void beginFrame(); // Closes the last frame.
+    void begin(NestPhase phase);
+    void end(NestPhase phase);
+
+    // Last frame's time and a smoothed average of the phase (ms).
+    float getTime(NestPhase phase) const;
+    float getAverage(NestPhase phase) const;
+    static std::string getName(NestPhase phase);
+
+    // One line per phase.
+    std::string toString() const;
+
+  private:
+    std::chrono::steady_clock::time_point startTimes[NumPhases];
+    float times[NumPhases]; // Current frame.
+    float lastTimes[NumPhases];
+    float averages[NumPhases];
+};
@@ -0,0 +1,649 @@
+#include "Nest.h"
+
+void Nest::setup(float w, float h) {
+  width = w;
+  height = h;
+
+  box2d.init();
+  box2d.setGravity(0, 0.0);
+  box2d.setFPS(60);
+  box2d.enableEvents();
+
+  ofAddListener(box2d.contactStartEvents, this, &Nest::contactStart);
+  ofAddListener(box2d.contactEndEvents, this, &Nest::contactEnd);
+  contacts.setup(1024);
+  bondCandidates.reserve(64);
+
+  // Init the joint mesh to start with.
+  SuperAgent::initJointMesh();
+
+  createBounds();
+  agentGrid.setup(width, height);
+
+  isOccupied = false;
+  shouldBond = false;
+  specialRepelTimer = 0;
+  ticks = 1;
+
+  // Pending deleted agents.
+  pendingAgentsNum = 0;
+  pendingAgentTime = 0;
+
+  agentIdx = 0;
+  accumulator = 0;
+  workerThreads = -1; // Started with the first tick.
+}
+
+void Nest::createBounds() {
+  ofLog() << "Creating new bounds." << endl;
+  bounds.x = -150; bounds.y = -150;
+  bounds.width = width + (-1) * bounds.x * 2; bounds.height = height + (-1) * 2 * bounds.y;
+  box2d.createBounds(bounds);
+}
+
+// The simulation runs at a fixed rate (props.physicsHz) no matter how fast we
+// render. Every rendered frame runs 0..maxSubSteps simulation ticks and the agent
+// meshes are drawn in between the last two physics states.
+void Nest::update(const std::vector<glm::vec2> &people, float dt) {
+  profiler.beginFrame();
+
+  // Input: who's in the room.
+  profiler.begin(NestPhase::Input);
+  audience = people;
+  isOccupied = audience.size() > 0;
+  profiler.end(NestPhase::Input);
+
+  // Run as many ticks as the elapsed time asks for, up to the cap, so a slow
+  // frame doesn't ask for even more work next frame.
+  float stepTime = 1.0 / props.physicsHz;
+  accumulator += dt;
+  int numSteps = 0;
+  while (accumulator >= stepTime && numSteps < props.maxSubSteps) {
+    tick();
+    accumulator -= stepTime;
+    numSteps++;
+  }
+  if (accumulator >= stepTime) {
+    accumulator = fmod(accumulator, stepTime); // Drop the time we can't catch up with.
+  }
+
+  // Draw in between the last two physics states.
+  float alpha = accumulator / stepTime;
+  for (auto &a : agents) {
+    a->interpolateMesh(alpha);
+  }
+}
+
+// Every agent goes through every phase exactly once per tick. The counters (stretch,
+// cool down, special repel) count 60 Hz frames, so they advance by the tick's length
+// in those and keep their timing at any physics rate.
+void Nest::tick() {
+  ticks = 60 / props.physicsHz;
+
+  // Physics step.
+  profiler.begin(NestPhase::Physics);
+  for (auto &a : agents) {
+    a->storePhysicsState();
+  }
+  box2d.setFPS(props.physicsHz);
+  contacts.beginStep();
+  box2d.update();
+  contacts.endStep();
+  processContacts();
+  profiler.end(NestPhase::Physics);
+
+  // Sync meshes (and GUI props) with the bodies.
+  profiler.begin(NestPhase::MeshSync);
+  for (auto &a : agents) {
+    a->syncMesh(alphaAgentProps, betaAgentProps);
+  }
+  profiler.end(NestPhase::MeshSync);
+
+  // Audience interaction sets the desires, agents act on them.
+  profiler.begin(NestPhase::Behaviors);
+  updateAgentGrid();
+  handleInteraction(audience);
+  if (props.behaviorThreads != workerThreads) {
+    workers.setup(props.behaviorThreads);
+    workerThreads = props.behaviorThreads;
+  }
+  // Forces are computed in parallel, box2d isn't thread safe so they're applied here.
+  workers.parallelFor(agents.size(), [&](int idx) {
+    agents[idx]->computeForces(ticks);
+  });
+  for (auto &a : agents) {
+    a->applyForces();
+  }
+  profiler.end(NestPhase::Behaviors);
+
+  // Break and create bonds.
+  profiler.begin(NestPhase::Bonding);
+  updateSuperAgents();
+  createSuperAgents();
+  profiler.end(NestPhase::Bonding);
+
+  // Explode stretched agents, reincarnate the pending ones.
+  profiler.begin(NestPhase::Lifecycle);
+  explodeAgents();
+  reincarnateAgents();
+  graph.update(agents, bonds); // Nests after this tick's bonds and explosions.
+  profiler.end(NestPhase::Lifecycle);
+
+  // Update broken bonds and exploded agents.
+  profiler.begin(NestPhase::Memories);
+  updateMemories();
+  profiler.end(NestPhase::Memories);
+}
+
+void Nest::exit() {
+  box2d.disableEvents();
+}
+
+void Nest::writeSnapshot(NestSnapshot &snapshot) {
+  // Agents: their meshes go one after the other in a single vertex array.
+  snapshot.agents.clear();
+  snapshot.vertices.clear();
+  for (auto &a : agents) {
+    auto &points = a->getMesh().getVertices();
+    AgentSnapshot agent { a->id, a->getShape(), (int) snapshot.vertices.size(), (int) points.size(), a->getCentroid(), a->visibilityRadius };
+    snapshot.agents.push_back(agent);
+    snapshot.vertices.insert(snapshot.vertices.end(), points.begin(), points.end());
+  }
+
+  // Inter-agent joints.
+  auto &lines = SuperAgent::jointMesh.getLines();
+  snapshot.jointLines.assign(lines.begin(), lines.end());
+
+  // Memories
+  snapshot.memories.clear();
+  for (auto &m : brokenBonds) {
+    snapshot.memories.push_back(m.getSnapshot());
+  }
+  for (auto &m : explodedAgent) {
+    snapshot.memories.push_back(m.getSnapshot());
+  }
+
+  snapshot.audience = audience;
+  snapshot.numNests = graph.getClusters().size();
+  snapshot.largestNest = graph.getLargestNestSize();
+  snapshot.profile = profiler.toString();
+}
+
+// ------------------------------ Lifecycle Routines --------------------------------------- //
+
+void Nest::updateSuperAgents() {
+  // Removing swaps the handles around, so go from the back.
+  auto &handles = bonds.getHandles();
+  for (int i = handles.size() - 1; i >= 0; i--) {
+    auto handle = handles[i];
+    auto sa = bonds.get(handle);
+    sa->update(box2d, brokenBonds, shouldBond);
+    if (sa->shouldRemove) {
+      bonds.remove(handle);
+      graph.removeBond();
+    }
+  }
+
+  // Lines of the joints that are left follow their bodies.
+  SuperAgent::jointMesh.update();
+}
+
+// Box2d destroys the joints along with the bodies, so the bonds of an agent have
+// to go before it's cleaned.
+void Nest::removeBonds(Agent *agent) {
+  auto agentBonds = bonds.getBonds(agent); // Copy, remove changes the list.
+  for (auto handle : agentBonds) {
+    bonds.get(handle)->markClean(box2d, brokenBonds);
+    bonds.remove(handle);
+    graph.removeBond();
+  }
+}
+
+void Nest::explodeAgents() {
+  int explodedIdx = 0;
+  ofRemove(agents, [&](Agent *a) {
+    if (a->canExplode()) { // Do everything when agent will explode!
+
+      // Fill exploded agents
+      for (int i = 0; i < a->vertices.size()/4; i++) {
+        Memory m (box2d, a->getCentroid(), true);
+        explodedAgent.push_back(m);
+      }
+
+      // Stop playing the stretch sound for the agent
+      a->agentStretchSound(false);
+
+      // Let the listeners (pop sound) know.
+      NestAgentEventArgs args { a, explodedIdx++ };
+      ofNotifyEvent(agentExplodedEvent, args, this);
+
+      if (pendingAgentsNum == 0) {
+          pendingAgentTime = ofGetElapsedTimeMillis(); // Reset time if it's the first time a new agent is deleted.
+      }
+
+      pendingAgentsNum++;
+      removeBonds(a);
+      graph.removeAgent(a);
+      a->clean(box2d); // Clean all the vertices and joints.
+
+      return true;
+    }
+    return false;
+  });
+}
+
+void Nest::reincarnateAgents() {
+  if (ofGetElapsedTimeMillis() - pendingAgentTime > props.reincarnationWaitTime && pendingAgentsNum > 0) {
+    ofLog() << "Time elaped: Creating Agents: " << pendingAgentsNum << endl;
+    if (pendingAgentsNum >= props.maxAgentsInWorld) {
+      pendingAgentsNum = props.maxAgentsInWorld;
+    }
+    createAgents(pendingAgentsNum);
+    pendingAgentsNum = 0;
+  }
+}
+
+void Nest::updateMemories() {
+  // Update broken bonds.
+  ofRemove(brokenBonds, [&](Memory &m) {
+    m.update();
+    if (m.shouldRemove) {
+      m.destroy();
+    }
+    return m.shouldRemove;
+  });
+
+  // Update explodedAgents
+  ofRemove(explodedAgent, [&](Memory &m) {
+    m.update();
+    if (m.shouldRemove) {
+      m.destroy();
+    }
+    return m.shouldRemove;
+  });
+}
+
+// ------------------------------ Agent Routines --------------------------------------- //
+
+void Nest::createAgents(int numAgents) {
+  for (int i = 0; i < numAgents; i++) {
+    ofPoint origin = ofPoint(ofRandom(100, width-100), ofRandom(100, height-100));
+    Agent *agent;
+    alphaAgentProps.meshOrigin = origin;
+    // Create new agent.
+    agent = new Alpha(box2d, alphaAgentProps);
+    agent->id = agentIdx;
+    agents.push_back(agent);
+    graph.addAgent(agent);
+    agentIdx++;
+
+    // Let the listeners (sound) patch the new agent.
+    NestAgentEventArgs args { agent, i };
+    ofNotifyEvent(agentCreatedEvent, args, this);
+  }
+
+  ofLog() << "Total Agents: " << agents.size() << endl;
+}
+
+void Nest::removeJoints() {
+  // Clear superAgents only
+  for (auto handle : bonds.getHandles()) {
+    bonds.get(handle)->clean(box2d);
+  }
+  bonds.clear();
+  graph.clear();
+  SuperAgent::initJointMesh(); // Clear the mesh and reinitialize
+}
+
+void Nest::clearScreen() {
+  // Destroying bodies fires contact end events. The queue ignores them since we aren't stepping.
+  contacts.clear();
+  bondCandidates.clear();
+
+  // Clear SuperAgents
+  for (auto handle : bonds.getHandles()) {
+    bonds.get(handle)->clean(box2d);
+  }
+  bonds.clear();
+  graph.clear();
+  SuperAgent::initJointMesh(); // Clear the joint mesh as well.
+
+  // Clean agents
+  for (auto &a : agents) {
+    a->clean(box2d);
+    delete a;
+  }
+  agents.clear();
+}
+
+// ------------------ Activate Agent Behaviors With Audience Interaction --------------------- //
+
+void Nest::handleInteraction(const std::vector<glm::vec2> &people) {
+  // Is the area occupied?
+  if (isOccupied) {
+    // Agents can bond now.
+    shouldBond = true;
+    setBehavior(people);
+    specialRepelTimer = ofRandom(200, 300);
+  } else {
+    for (auto &a : agents) {
+      a->agentStretchSound(false); // It can happen here that targets disappear.
+    }
+    if (specialRepelTimer > 0) {
+      enableRepelBeforeBreak();
+    } else {
+      // Do other silly things
+      wasteTime();
+      clearInterAgentBonds();
+    }
+  }
+}
+
+void Nest::setBehavior(const std::vector<glm::vec2> &people) {
+  // Get all visible agents. Remember which person sees which agent.
+  visibility.assign(agents.size() * people.size(), 0);
+  visibleCount.assign(agents.size(), 0);
+  for (int p = 0; p < people.size(); p++) {
+    agentGrid.getVisible(people[p], visibleIdx);
+    for (auto idx : visibleIdx) {
+      visibility[idx * people.size() + p] = 1;
+      visibleCount[idx]++;
+    }
+  }
+
+  // Who's touched: a silhouette in the agent's visibility radius, or else a person who
+  // can see it.
+  touched.resize(agents.size());
+  for (int idx = 0; idx < agents.size(); idx++) {
+    if (occupancy.isSetup()) {
+      auto a = agents[idx];
+      auto c = a->getCentroid(); auto r = a->visibilityRadius;
+      touched[idx] = occupancy.isOccupied(ofRectangle(c.x - r, c.y - r, 2 * r, 2 * r));
+    } else {
+      touched[idx] = visibleCount[idx] > 0;
+    }
+  }
+
+  // Apply stretch on touched agents
+  for (int idx = 0; idx < agents.size(); idx++) {
+    if (touched[idx]) {
+      auto a = agents[idx];
+      a->setBehavior(Behavior::Stretch, {}, true); // All touched agents, turn on the note! They turn it off, as soon as they're let go
+      a->agentStretchSound(true);
+    }
+  }
+
+  // Toss a coin on the invisible targets for each agent
+  // to attract or repel from the people.
+  for (int idx = 0; idx < agents.size(); idx++) {
+    auto a = agents[idx];
+    auto &targets = getInvisibleTargets(people, idx);
+    if (ofRandom(1) < 0.85) {
+      a->setBehavior(Behavior::Attract, targets);
+    } else {
+      a->setBehavior(Behavior::Repel, targets);
+    }
+
+    // If nobody's touching it, turn off the midi.
+    if (!touched[idx]) {
+      a->agentStretchSound(false);
+      a->stretchCounter = 0;
+    }
+  }
+}
+
+void Nest::wasteTime() {
+  for (auto &a : agents) {
+    auto target = glm::vec2(ofRandom(50, width-50), ofRandom(50, height-50));
+    if (ofRandom(1) < 0.3) { // Low priority for seeking targets. Lower the movement.
+      a->setBehavior(Behavior::Attract, { target });
+    } else {
+      a->setBehavior(Behavior::Shock);
+    }
+  }
+}
+
+void Nest::enableRepelBeforeBreak() {
+  if (bonds.size() > 0) {
+    // Keep tracking time.
+    if (specialRepelTimer > 0) {
+      specialRepelTimer -= ticks;
+    }
+
+    // Enable special repel. Every bonded agent pulls away from the rest of its nest
+    // (for a pair, that's the other agent).
+    auto &nests = graph.getClusters();
+    for (auto &a : agents) {
+      auto idx = graph.getCluster(a);
+      if (idx < 0) {
+        continue;
+      }
+      auto &nest = nests[idx];
+      auto others = (nest.sum - a->getCentroid()) / (float) (nest.size - 1);
+      a->setBehavior(Behavior::SpecialRepel, { others });
+    }
+  }
+}
+
+void Nest::clearInterAgentBonds() {
+  shouldBond = false;
+  if (bonds.size() == 0) {
+    SuperAgent::initJointMesh(); // Clear the mesh and reinitialize
+  }
+}
+
+void Nest::updateAgentGrid() {
+  // Every agent is a circle reaching as far as a person can see it.
+  agentGrid.clear();
+  for (int idx = 0; idx < agents.size(); idx++) {
+    auto a = agents[idx];
+    agentGrid.add(idx, a->getCentroid(), a->visibilityRadius + props.audienceVisibilityRadius);
+  }
+  agentGrid.build();
+}
+
+Agent* Nest::getClosestAgent(glm::vec2 targetPos) {
+  auto idx = agentGrid.getClosest(targetPos);
+  return idx >= 0 ? agents[idx] : NULL;
+}
+
+// Uses the visibility table built in setBehavior. Valid until the next call.
+const std::vector<glm::vec2> &Nest::getInvisibleTargets(const std::vector<glm::vec2> &people, int agentIdx) {
+  // Most agents can't be seen by anyone.
+  if (visibleCount[agentIdx] == 0) {
+    return people;
+  }
+  
+  invisibleTargets.clear();
+  for (int p = 0; p < people.size(); p++) {
+    if (!visibility[agentIdx * people.size() + p]) {
+      invisibleTargets.push_back(people[p]);
+    }
+  }
+
+  return invisibleTargets;
+}
+
+std::vector<Agent *> Nest::getVisibleAgents(glm::vec2 target) {
+  std::vector<Agent *> visibleAgents;
+  agentGrid.getVisible(target, visibleIdx);
+  for (auto idx : visibleIdx) {
+    visibleAgents.push_back(agents[idx]);
+  }
+
+  return visibleAgents;
+}
+
+std::vector<Agent*> Nest::getInvisibleAgents(glm::vec2 target) {
+  std::vector<Agent *> invisibleAgents;
+  std::vector<char> visible(agents.size(), 0);
+  agentGrid.getVisible(target, visibleIdx);
+  for (auto idx : visibleIdx) {
+    visible[idx] = 1;
+  }
+  
+  for (int idx = 0; idx < agents.size(); idx++) {
+    if (!visible[idx]) {
+      invisibleAgents.push_back(agents[idx]);
+    }
+  }
+
+  return invisibleAgents;
+}
+
+// ------------------------------ Agent Body Contact Routines --------------------------------------- //
+
+void Nest::contactStart(ofxBox2dContactArgs &e) {
+  contacts.push(e, true);
+}
+
+void Nest::contactEnd(ofxBox2dContactArgs &e) {
+  contacts.push(e, false);
+}
+
+// Handles every contact of the last step, then keeps a single bond candidate for
+// every pair of agents that touched.
+void Nest::processContacts() {
+  bondCandidates.clear();
+  for (auto &c : contacts.getContacts()) {
+    if (!c.isStart) {
+      handleContactEnd(c.bodyA, c.bodyB);
+    }
+  }
+  contacts.clear();
+
+  // First candidate of every agent pair wins.
+  std::stable_sort(bondCandidates.begin(), bondCandidates.end(), [](const BondCandidate &a, const BondCandidate &b) {
+    return a.agentPair < b.agentPair;
+  });
+  auto last = std::unique(bondCandidates.begin(), bondCandidates.end(), [](const BondCandidate &a, const BondCandidate &b) {
+    return a.agentPair == b.agentPair;
+  });
+  bondCandidates.erase(last, bondCandidates.end());
+}
+
+// Joint creation sequence.
+void Nest::handleContactEnd(b2Body *bodyA, b2Body *bodyB) {
+  // Based on the current state of desire, what should the vertices do if they hit each other
+  // How do they effect each other?
+  if (agents.size() > 0) {
+    // Collect datas
+    auto dataA = reinterpret_cast<VertexData*>(bodyA->GetUserData());
+    auto dataB = reinterpret_cast<VertexData*>(bodyB->GetUserData());
+    if (dataA == NULL || dataB == NULL) {
+      return; // Not an agent's vertex.
+    }
+
+    // Extract Agent pointers.
+    Agent* agentA = dataA->agent;
+    Agent* agentB = dataB->agent;
+
+    // DEFINE INDIVIDUAL VERTEX BEHAVIORS.
+    if (agentA != agentB && agentA != NULL && agentB != NULL) {
+      // Update positions for repelling.
+      dataA->targetPos = getBodyPosition(bodyB);
+      dataB->targetPos = getBodyPosition(bodyA);
+
+      // Desire state is NONE! Repel the vertices from each
+      if (agentA->currentBehavior == None) {
+        if (ofRandom(1) < 0.90) {
+          dataA->applyRepulsion = true;
+        } else {
+          dataA->applyAttraction = true;
+        }
+      }
+
+      if (agentB->currentBehavior == None) {
+        if (ofRandom(1) < 0.90) {
+          dataA->applyRepulsion = true;
+        } else {
+          dataB->applyAttraction = true;
+        }
+      }
+
+      // If agents can bond, evaluate the colliding bodies for collision.
+      // Along with the agents they both belong to.
+      if (shouldBond) {
+        evaluateBonding(bodyA, bodyB, agentA, agentB);
+      }
+    }
+  }
+}
+
+// ------------------------------ Inter-Agent Bonding Routines ------------------------------------ //
+
+// Critical routine that evaluates when the 2 bodies should actually bond to each other.
+void Nest::evaluateBonding(b2Body *bodyA, b2Body *bodyB, Agent *agentA, Agent *agentB) {
+  if (agentA->stretchCounter<100 && agentB->stretchCounter<100) {
+    // Vertex level checks. Is this vertex bonded to anything except itself?
+    bool a = canVertexBond(bodyA, agentA);
+    bool b = canVertexBond(bodyB, agentB);
+    if (a && b) {
+      // Prepare for bond.
+      bondCandidates.push_back({ bodyA, bodyB, BondRegistry::getKey(agentA, agentB) });
+    }
+  }
+}
+
+bool Nest::canVertexBond(b2Body* body, Agent *curAgent) {
+  // Does it have an interAgent joint already? If it doesn, can't allow this body to create another joint.
+  auto data = reinterpret_cast<VertexData*>(body->GetUserData());
+  return !data->hasInterAgentJoint;
+}
+
+void Nest::createSuperAgents() {
+  // Joint creation based on when two bodies collided at certain vertices.
+  for (auto &c : bondCandidates) {
+    auto agentA = reinterpret_cast<VertexData*>(c.bodyA->GetUserData())->agent;
+    auto agentB = reinterpret_cast<VertexData*>(c.bodyB->GetUserData())->agent;
+
+    // An earlier candidate (or a bond that broke) could have changed the vertices.
+    // Agents about to explode lose their bodies in the lifecycle phase.
+    if (!canVertexBond(c.bodyA, agentA) || !canVertexBond(c.bodyB, agentB)
+        || agentA->canExplode() || agentB->canExplode()) {
+      continue;
+    }
+
+    // If both the agents have that state, then they'll bond.
+    auto j = createInterAgentJoint(c.bodyA, c.bodyB);
+    auto handle = bonds.find(agentA, agentB);
+    if (bonds.isValid(handle)) {
+      bonds.get(handle)->joints.push_back(j); // The SuperAgent already exists.
+    } else {
+      bonds.add(agentA, agentB, j); // Create a new super agent.
+      graph.addBond(agentA, agentB);
+    }
+  }
+
+  bondCandidates.clear();
+}
+
+std::shared_ptr<ofxBox2dJoint> Nest::createInterAgentJoint(b2Body *bodyA, b2Body *bodyB) {
+    auto j = std::make_shared<ofxBox2dJoint>();
+    j->setup(box2d.getWorld(), bodyA, bodyB, props.jointPhysics.x, props.jointPhysics.y); // Use the interAgentJoint props.
+
+    // Joint length (determine with probability)
+    int jointLength = ofRandom(props.jointLength.x, props.jointLength.y);
+    j->setLength(jointLength);
+
+    // Update Body A
+    auto data = reinterpret_cast<VertexData*>(bodyA->GetUserData());
+    data->hasInterAgentJoint = true;
+
+    // Update Body B
+    data = reinterpret_cast<VertexData*>(bodyB->GetUserData());
+    data->hasInterAgentJoint = true;
+
+    // Insert these into mesh for the interAgent joints. It sets the jointMeshIdx of both bodies.
+    SuperAgent::jointMesh.add(bodyA, bodyB);
+
+    return j;
+}
+
+glm::vec2 Nest::getBodyPosition(b2Body* body) {
+  auto xf = body->GetTransform();
+  b2Vec2 pos = body->GetLocalCenter();
+  b2Vec2 b2Center = b2Mul(xf, pos);
+  auto p = worldPtToscreenPt(b2Center);
+  return glm::vec2(p.x, p.y);
+}
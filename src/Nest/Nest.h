@@ -0,0 +1,163 @@
+// Nest is the simulation core of the installation. It owns the Box2D world, the agents,
+// the inter-agent bonds (SuperAgents) and the memories they leave behind. It has no
+// knowledge of windows, fbos, shaders or the Kinect, so it can be stepped without a
+// GL context (see nest_headless). ofApp feeds it audience positions and draws its state.
+#pragma once
+#include "ofMain.h"
+#include "ofxBox2d.h"
+#include "Agent.h"
+#include "Alpha.h"
+#include "Beta.h"
+#include "Memory.h"
+#include "SuperAgent.h"
+#include "AgentGrid.h"
+#include "OccupancyGrid.h"
+#include "FrameProfiler.h"
+#include "ContactQueue.h"
+#include "BondRegistry.h"
+#include "NestGraph.h"
+#include "WorkerPool.h"
+#include "NestSnapshot.h"
+
+// World level properties. ofApp populates these from the GUI every frame.
+struct NestProperties {
+  float audienceVisibilityRadius;
+  int maxAgentsInWorld;
+  int reincarnationWaitTime; // ms
+  // Fixed timestep
+  float physicsHz = 60;
+  int maxSubSteps = 4; // Per rendered frame.
+  // Threads computing the agent behaviors (0: one per core).
+  int behaviorThreads = 0;
+  // InterAgentJoint
+  ofPoint jointPhysics; // frequency, damping
+  ofPoint jointLength; // min, max
+};
+
+// Payload for the agent events, so listeners (sound) can patch a new agent.
+struct NestAgentEventArgs {
+  Agent *agent;
+  int idx; // Index of the agent in the batch it was created in.
+};
+
+// Two vertices of different agents that touched during a step and can bond.
+struct BondCandidate {
+  b2Body *bodyA;
+  b2Body *bodyB;
+  uint64_t agentPair; // Both agent ids, smaller one first.
+};
+
+class Nest {
+  public:
+    void setup(float width, float height);
+    void update(const std::vector<glm::vec2> &people, float dt); // dt: seconds since the last frame.
+    void exit();
+    void createBounds();
+
+    // Copy what there is to draw. Reuses the snapshot's buffers.
+    void writeSnapshot(NestSnapshot &snapshot);
+
+    // Agents
+    void createAgents(int numAgents);
+    void clearScreen();
+    void removeJoints();
+
+    // Flags
+    bool shouldBond;
+    bool isOccupied;
+
+    // Box2d world handle.
+    ofxBox2d box2d;
+
+    // Agents
+    std::vector<Agent *> agents;
+    AlphaAgentProperties alphaAgentProps;
+    BetaAgentProperties betaAgentProps;
+    NestProperties props;
+
+    // Where the audience's silhouettes are. When it's set up, it decides which agents
+    // are touched instead of the audience points and audienceVisibilityRadius.
+    OccupancyGrid occupancy;
+
+    // SuperAgents => These are abstract agents that have a bond with each other.
+    BondRegistry bonds;
+    NestGraph graph; // Agents connected through bonds.
+
+    // Memories
+    std::vector<Memory> brokenBonds;
+    std::vector<Memory> explodedAgent;
+
+    // Time spent in every phase of the frame.
+    FrameProfiler profiler;
+
+    // Events
+    ofEvent<NestAgentEventArgs> agentCreatedEvent;
+    ofEvent<NestAgentEventArgs> agentExplodedEvent;
+
+  private:
+    // One fixed simulation step.
+    void tick();
+
+    // Interaction
+    void handleInteraction(const std::vector<glm::vec2> &people);
+    void setBehavior(const std::vector<glm::vec2> &people);
+    void wasteTime();
+    void enableRepelBeforeBreak();
+    void clearInterAgentBonds();
+  
+    // Audience visibility queries. They all go through the agent grid.
+    void updateAgentGrid();
+    Agent *getClosestAgent(glm::vec2 targetPos);
+    std::vector<Agent *> getVisibleAgents(glm::vec2 person);
+    std::vector<Agent *> getInvisibleAgents(glm::vec2 person);
+    const std::vector<glm::vec2> &getInvisibleTargets(const std::vector<glm::vec2> &targets, int agentIdx);
+
+    // Lifecycle
+    void updateSuperAgents();
+    void removeBonds(Agent *agent);
+    void explodeAgents();
+    void reincarnateAgents();
+    void updateMemories();
+
+    // Contact listening callbacks. They only queue the contact, it's handled after the step.
+    void contactStart(ofxBox2dContactArgs &e);
+    void contactEnd(ofxBox2dContactArgs &e);
+    void processContacts();
+    void handleContactEnd(b2Body *bodyA, b2Body *bodyB);
+
+    // Super Agents (Inter Agent Bonding Logic)
+    void createSuperAgents();
+    std::shared_ptr<ofxBox2dJoint> createInterAgentJoint(b2Body *bodyA, b2Body *bodyB);
+    void evaluateBonding(b2Body* bodyA, b2Body* bodyB, Agent *agentA, Agent *agentB);
+    bool canVertexBond(b2Body* body, Agent *curAgent);
+    glm::vec2 getBodyPosition(b2Body* body);
+
+    std::vector<glm::vec2> audience; // People in the room this frame.
+    std::vector<char> touched; // Per agent, somebody's in its visibility radius.
+    ContactQueue contacts;
+    std::vector<BondCandidate> bondCandidates; // Collected from this step's contacts.
+  
+    // Grid of agent reach circles, rebuilt every frame.
+    AgentGrid agentGrid;
+    std::vector<int> visibleIdx; // Scratch for grid queries.
+    std::vector<char> visibility; // agents x people, 1 if the person can see the agent.
+    std::vector<int> visibleCount; // Number of people that can see the agent.
+    std::vector<glm::vec2> invisibleTargets; // Scratch for getInvisibleTargets.
+    float specialRepelTimer; // Keeps track of the repelling (60 Hz frames).
+    float ticks; // Length of this tick in 60 Hz frames.
+
+    // Pending time to track agents killed.
+    int pendingAgentsNum;
+    long pendingAgentTime;
+
+    // World
+    float width;
+    float height;
+    ofRectangle bounds;
+    int agentIdx;
+    float accumulator; // Time the simulation still has to catch up with (s).
+  
+    // Threads for the behaviors.
+    WorkerPool workers;
+    int workerThreads;
+};
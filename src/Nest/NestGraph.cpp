@@ -0,0 +1,120 @@
+#include "NestGraph.h"
+
+void NestGraph::addAgent(Agent *agent) {
+  getNode(agent);
+}
+
+void NestGraph::removeAgent(Agent *agent) {
+  // Its nest might fall apart.
+  isDirty = true;
+}
+
+void NestGraph::addBond(Agent *agentA, Agent *agentB) {
+  merge(getNode(agentA), getNode(agentB));
+}
+
+void NestGraph::removeBond() {
+  // Union-find can't split, rebuild from the bonds that are left.
+  isDirty = true;
+}
+
+void NestGraph::clear() {
+  nodes.clear();
+  parent.clear();
+  sizes.clear();
+  clusters.clear();
+  nodeCluster.clear();
+  isDirty = false;
+}
+
+void NestGraph::update(const std::vector<Agent *> &agents, BondRegistry &bonds) {
+  if (isDirty) {
+    clear();
+    for (auto a : agents) {
+      getNode(a);
+    }
+    for (auto handle : bonds.getHandles()) {
+      auto sa = bonds.get(handle);
+      merge(getNode(sa->agentA), getNode(sa->agentB));
+    }
+  }
+
+  // One cluster for every root with more than one agent.
+  clusters.clear();
+  nodeCluster.assign(parent.size(), -1);
+  for (auto a : agents) {
+    auto node = getNode(a);
+    auto root = find(node);
+    if (sizes[root] < 2) {
+      continue;
+    }
+
+    if (nodeCluster[root] < 0) {
+      nodeCluster[root] = clusters.size();
+      clusters.push_back({ 0, glm::vec2(0, 0), glm::vec2(0, 0) });
+    }
+    auto &c = clusters[nodeCluster[root]];
+    c.size++;
+    c.sum += a->getCentroid();
+    nodeCluster[node] = nodeCluster[root];
+  }
+
+  for (auto &c : clusters) {
+    c.centroid = c.sum / (float) c.size;
+  }
+}
+
+bool NestGraph::isSameNest(Agent *agentA, Agent *agentB) {
+  return find(getNode(agentA)) == find(getNode(agentB));
+}
+
+int NestGraph::getCluster(Agent *agent) {
+  auto it = nodes.find(agent->id);
+  if (it == nodes.end() || it->second >= nodeCluster.size()) {
+    return -1;
+  }
+  return nodeCluster[it->second];
+}
+
+int NestGraph::getLargestNestSize() const {
+  int largest = 0;
+  for (auto &c : clusters) {
+    largest = std::max(largest, c.size);
+  }
+  return largest;
+}
+
+int NestGraph::getNode(Agent *agent) {
+  auto it = nodes.find(agent->id);
+  if (it != nodes.end()) {
+    return it->second;
+  }
+
+  int node = parent.size();
+  nodes[agent->id] = node;
+  parent.push_back(node);
+  sizes.push_back(1);
+  return node;
+}
+
+int NestGraph::find(int node) {
+  while (parent[node] != node) {
+    parent[node] = parent[parent[node]]; // Path halving.
+    node = parent[node];
+  }
+  return node;
+}
+
+void NestGraph::merge(int nodeA, int nodeB) {
+  auto rootA = find(nodeA); auto rootB = find(nodeB);
+  if (rootA == rootB) {
+    return;
+  }
+
+  // Smaller tree goes under the bigger one.
+  if (sizes[rootA] < sizes[rootB]) {
+    std::swap(rootA, rootB);
+  }
+  parent[rootB] = rootA;
+  sizes[rootA] += sizes[rootB];
+}
@@ -0,0 +1,48 @@
+// Which agents are bonded into the same nest, directly or through other agents.
+// Bonds merge nests right away (union-find). Breaking a bond or losing an agent can
+// split a nest, that just marks the graph dirty and it's rebuilt from the bonds on
+// the next update.
+#pragma once
+#include "ofMain.h"
+#include "Agent.h"
+#include "BondRegistry.h"
+
+// A connected group of bonded agents.
+struct NestCluster {
+  int size; // Number of agents.
+  glm::vec2 centroid; // Average of the agent centroids.
+  glm::vec2 sum; // Sum of the agent centroids.
+};
+
+class NestGraph {
+  public:
+    void addAgent(Agent *agent);
+    void removeAgent(Agent *agent);
+    void addBond(Agent *agentA, Agent *agentB);
+    void removeBond();
+    void clear();
+
+    // Rebuilds after splits and summarizes the clusters. Once per tick.
+    void update(const std::vector<Agent *> &agents, BondRegistry &bonds);
+
+    bool isSameNest(Agent *agentA, Agent *agentB);
+    // Cluster of the agent as of the last update (-1 if it isn't bonded to anybody).
+    int getCluster(Agent *agent);
+    const std::vector<NestCluster> &getClusters() const { return clusters; }
+    int getLargestNestSize() const;
+
+  private:
+    int getNode(Agent *agent);
+    int find(int node);
+    void merge(int nodeA, int nodeB);
+
+    // Union-find over the agents, by size with path halving.
+    std::unordered_map<int, int> nodes; // Agent id -> node.
+    std::vector<int> parent;
+    std::vector<int> sizes;
+    bool isDirty = false;
+
+    // Clusters of the last update (only the nests, single agents aren't one).
+    std::vector<NestCluster> clusters;
+    std::vector<int> nodeCluster; // Node -> cluster.
+};
@@ -0,0 +1,26 @@
+// Everything the renderer needs from one step of the nest, copied out of the
+// simulation so it can be drawn while the next step runs.
+#pragma once
+#include "ofMain.h"
+#include "Agent.h"
+#include "Memory.h"
+
+struct AgentSnapshot {
+  int id;
+  std::shared_ptr<const AgentShape> shape;
+  int firstVertex; // Into NestSnapshot::vertices.
+  int numVertices;
+  glm::vec2 centroid;
+  float visibilityRadius;
+};
+
+struct NestSnapshot {
+  std::vector<AgentSnapshot> agents;
+  std::vector<glm::vec3> vertices; // Mesh vertices of all the agents.
+  std::vector<glm::vec3> jointLines; // Inter-agent joints, two points per line.
+  std::vector<MemorySnapshot> memories; // Broken bonds and exploded agents.
+  std::vector<glm::vec2> audience;
+  int numNests = 0;
+  int largestNest = 0;
+  std::string profile; // FrameProfiler of the step.
+};
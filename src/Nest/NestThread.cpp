@@ -0,0 +1,130 @@
+#include "NestThread.h"
+
+void NestThread::setup(Nest *n) {
+  nest = n;
+  ofAddListener(nest->agentCreatedEvent, this, &NestThread::onAgentCreated);
+  ofAddListener(nest->agentExplodedEvent, this, &NestThread::onAgentExploded);
+}
+
+void NestThread::exit() {
+  setThreaded(false);
+  ofRemoveListener(nest->agentCreatedEvent, this, &NestThread::onAgentCreated);
+  ofRemoveListener(nest->agentExplodedEvent, this, &NestThread::onAgentExploded);
+}
+
+void NestThread::setThreaded(bool threaded) {
+  if (threaded && !isThreadRunning()) {
+    ofLog() << "Stepping the nest on its own thread." << endl;
+    startThread();
+  } else if (!threaded && isThreadRunning()) {
+    ofLog() << "Stepping the nest on the main thread." << endl;
+    waitForThread(true); // Lets the current step finish.
+  }
+}
+
+// ------------------------------ Main Thread --------------------------------------- //
+
+void NestThread::setInput(const std::vector<glm::vec2> &p, const AlphaAgentProperties &alpha,
+                          const BetaAgentProperties &beta, const NestProperties &nestProps,
+                          const OccupancyGrid &grid) {
+  std::lock_guard<std::mutex> lock(inputMutex);
+  people = p;
+  alphaProps = alpha;
+  betaProps = beta;
+  props = nestProps;
+  occupancy = grid;
+  hasInput = true;
+}
+
+void NestThread::post(std::function<void(Nest &)> command) {
+  std::lock_guard<std::mutex> lock(inputMutex);
+  commands.push_back(command);
+}
+
+void NestThread::update(float dt) {
+  if (!isThreadRunning()) {
+    step(dt);
+  }
+  snapshots.update();
+  dispatchEvents();
+}
+
+void NestThread::dispatchEvents() {
+  std::lock_guard<std::recursive_mutex> lock(eventMutex);
+  for (auto &e : events) {
+    if (e.isCreated) {
+      ofNotifyEvent(agentCreatedEvent, e.args, this);
+    } else {
+      ofNotifyEvent(agentExplodedEvent, e.args, this);
+    }
+  }
+  events.clear();
+}
+
+// ------------------------------ Simulation Thread --------------------------------------- //
+
+void NestThread::threadedFunction() {
+  auto lastTime = std::chrono::steady_clock::now();
+  while (isThreadRunning()) {
+    auto now = std::chrono::steady_clock::now();
+    float dt = std::chrono::duration<float>(now - lastTime).count();
+    lastTime = now;
+    step(dt);
+
+    // Nothing new to simulate until the next tick is due.
+    auto stepTime = std::chrono::duration<float>(1.0 / std::max(nest->props.physicsHz, 1.f));
+    std::this_thread::sleep_until(now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(stepTime));
+  }
+}
+
+void NestThread::step(float dt) {
+  std::vector<glm::vec2> audience;
+  {
+    std::lock_guard<std::mutex> lock(inputMutex);
+    if (!hasInput) {
+      return;
+    }
+    audience = people;
+    nest->alphaAgentProps = alphaProps;
+    nest->betaAgentProps = betaProps;
+    nest->props = props;
+    nest->occupancy = occupancy;
+  }
+
+  runCommands();
+  nest->update(audience, dt);
+
+  nest->writeSnapshot(snapshots.getWriteBuffer());
+  snapshots.publish();
+}
+
+void NestThread::runCommands() {
+  std::vector<std::function<void(Nest &)>> pending;
+  {
+    std::lock_guard<std::mutex> lock(inputMutex);
+    pending.swap(commands);
+  }
+  if (pending.empty()) {
+    return;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock(eventMutex);
+  for (auto &command : pending) {
+    command(*nest);
+  }
+
+  // Agents created and cleared before the main thread got to them.
+  ofRemove(events, [&](PendingEvent &e) {
+    return e.isCreated && std::find(nest->agents.begin(), nest->agents.end(), e.args.agent) == nest->agents.end();
+  });
+}
+
+void NestThread::onAgentCreated(NestAgentEventArgs &args) {
+  std::lock_guard<std::recursive_mutex> lock(eventMutex);
+  events.push_back({ args, true });
+}
+
+void NestThread::onAgentExploded(NestAgentEventArgs &args) {
+  std::lock_guard<std::recursive_mutex> lock(eventMutex);
+  events.push_back({ args, false });
+}
@@ -0,0 +1,63 @@
+// Runs the nest either on its own thread or inline on the main thread, so a slow
+// frame on one side never stalls the other. After every step the nest is copied into
+// a snapshot the renderer picks up without locking. Everything else that goes to the
+// nest (GUI props, audience, commands) is handed over here and applied before a step.
+#pragma once
+#include "ofMain.h"
+#include "Nest.h"
+#include "NestSnapshot.h"
+#include "TripleBuffer.h"
+
+class NestThread : public ofThread {
+  public:
+    void setup(Nest *nest);
+    void exit();
+
+    // Start or stop stepping the nest on its own thread.
+    void setThreaded(bool threaded);
+    bool isThreaded() { return isThreadRunning(); }
+
+    // Main thread
+    void setInput(const std::vector<glm::vec2> &people, const AlphaAgentProperties &alphaProps,
+                  const BetaAgentProperties &betaProps, const NestProperties &props,
+                  const OccupancyGrid &occupancy = OccupancyGrid()); // Not set up: just the people.
+    void post(std::function<void(Nest &)> command); // Runs on the simulation thread before the next step.
+    void update(float dt); // Steps the nest when it's inline, picks up the latest snapshot and forwards the events.
+    const NestSnapshot &getSnapshot() const { return snapshots.getReadBuffer(); } // As of the last update.
+
+    // Nest events, always fired on the main thread (from update).
+    ofEvent<NestAgentEventArgs> agentCreatedEvent;
+    ofEvent<NestAgentEventArgs> agentExplodedEvent;
+
+  private:
+    void threadedFunction() override;
+    void step(float dt);
+    void runCommands();
+    void dispatchEvents();
+
+    // Nest callbacks, on whichever thread steps the nest.
+    void onAgentCreated(NestAgentEventArgs &args);
+    void onAgentExploded(NestAgentEventArgs &args);
+
+    Nest *nest = NULL;
+    TripleBuffer<NestSnapshot> snapshots;
+
+    // Input for the next step.
+    std::mutex inputMutex;
+    std::vector<glm::vec2> people;
+    AlphaAgentProperties alphaProps;
+    BetaAgentProperties betaProps;
+    NestProperties props;
+    OccupancyGrid occupancy;
+    bool hasInput = false;
+    std::vector<std::function<void(Nest &)>> commands;
+
+    // Events waiting for the main thread. Commands run under this lock too, so an
+    // agent can't be deleted while its event is being handled.
+    struct PendingEvent {
+      NestAgentEventArgs args;
+      bool isCreated;
+    };
+    std::recursive_mutex eventMutex; // Commands fire nest events themselves.
+    std::vector<PendingEvent> events;
+};
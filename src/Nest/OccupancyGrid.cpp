@@ -0,0 +1,83 @@
+#include "OccupancyGrid.h"
+
+void OccupancyGrid::setup(float w, float h, float size) {
+  if (w != width || h != height || size != cellSize) {
+    width = w;
+    height = h;
+    cellSize = std::max(size, 1.f);
+    numCols = std::max(1, (int) ceil(width / cellSize));
+    numRows = std::max(1, (int) ceil(height / cellSize));
+  }
+  clear();
+}
+
+void OccupancyGrid::clear() {
+  cells.assign(numCols * numRows, 0);
+  sums.assign((numCols + 1) * (numRows + 1), 0);
+}
+
+void OccupancyGrid::addPolygon(const std::vector<glm::vec2> &points) {
+  if (points.size() < 3) {
+    return;
+  }
+  // Rows the polygon spans.
+  float minY = points[0].y, maxY = points[0].y;
+  for (auto &p : points) {
+    minY = std::min(minY, p.y);
+    maxY = std::max(maxY, p.y);
+  }
+  int row0 = std::max(0, (int) ceil(minY / cellSize - 0.5));
+  int row1 = std::min(numRows - 1, (int) floor(maxY / cellSize - 0.5));
+
+  // Even-odd scanline through the center of every row.
+  for (int row = row0; row <= row1; row++) {
+    float y = (row + 0.5) * cellSize;
+    crossings.clear();
+    for (int i = 0, j = points.size() - 1; i < points.size(); j = i++) {
+      auto &a = points[i]; auto &b = points[j];
+      if ((a.y > y) != (b.y > y)) {
+        crossings.push_back(a.x + (y - a.y) / (b.y - a.y) * (b.x - a.x));
+      }
+    }
+    std::sort(crossings.begin(), crossings.end());
+    for (int c = 0; c + 1 < crossings.size(); c += 2) {
+      int col0 = std::max(0, (int) ceil(crossings[c] / cellSize - 0.5));
+      int col1 = std::min(numCols - 1, (int) floor(crossings[c + 1] / cellSize - 0.5));
+      for (int col = col0; col <= col1; col++) {
+        cells[row * numCols + col] = 1;
+      }
+    }
+  }
+}
+
+void OccupancyGrid::build() {
+  int stride = numCols + 1;
+  for (int row = 0; row < numRows; row++) {
+    int rowSum = 0;
+    for (int col = 0; col < numCols; col++) {
+      rowSum += cells[row * numCols + col];
+      sums[(row + 1) * stride + col + 1] = sums[row * stride + col + 1] + rowSum;
+    }
+  }
+}
+
+bool OccupancyGrid::isOccupied(glm::vec2 p) const {
+  int col = floor(p.x / cellSize); int row = floor(p.y / cellSize);
+  if (col < 0 || row < 0 || col >= numCols || row >= numRows) {
+    return false;
+  }
+  return cells[row * numCols + col];
+}
+
+bool OccupancyGrid::isOccupied(const ofRectangle &box) const {
+  int col0 = std::max(0, (int) floor(box.getLeft() / cellSize));
+  int row0 = std::max(0, (int) floor(box.getTop() / cellSize));
+  int col1 = std::min(numCols - 1, (int) floor(box.getRight() / cellSize));
+  int row1 = std::min(numRows - 1, (int) floor(box.getBottom() / cellSize));
+  if (col0 > col1 || row0 > row1) {
+    return false;
+  }
+  int stride = numCols + 1;
+  return sums[(row1 + 1) * stride + col1 + 1] - sums[row0 * stride + col1 + 1]
+       - sums[(row1 + 1) * stride + col0] + sums[row0 * stride + col0] > 0;
+}
@@ -0,0 +1,35 @@
+// Coarse bitmap of where the audience's silhouettes are on the screen. It's rasterized
+// from their contours once per frame, and then "is anybody in this box?" is a lookup in
+// a summed area table, however many people there are and whatever their shape.
+#pragma once
+#include "ofMain.h"
+
+class OccupancyGrid {
+  public:
+    // Resizes only when the size changes. Clears the cells.
+    void setup(float width, float height, float cellSize);
+    void clear();
+    bool isSetup() const { return numCols > 0; }
+
+    // Fills the cells whose centers are inside the closed polygon (screen).
+    void addPolygon(const std::vector<glm::vec2> &points);
+    void build(); // After the polygons, before the lookups.
+
+    bool isOccupied(glm::vec2 p) const;
+    bool isOccupied(const ofRectangle &box) const; // Any cell the box touches.
+
+    float getCellSize() const { return cellSize; }
+    int getNumCols() const { return numCols; }
+    int getNumRows() const { return numRows; }
+    bool isCellOccupied(int col, int row) const { return cells[row * numCols + col]; }
+
+  private:
+    float width = 0;
+    float height = 0;
+    float cellSize = 1;
+    int numCols = 0;
+    int numRows = 0;
+    std::vector<unsigned char> cells; // 1: somebody's there.
+    std::vector<int> sums; // (numCols + 1) x (numRows + 1), occupied cells above and left.
+    std::vector<float> crossings; // Scratch for the scanlines.
+};
@@ -0,0 +1,36 @@
+// Hands values from one writer thread to one reader thread without locks. The writer
+// always has a buffer to fill and the reader always has the latest complete one, so
+// neither ever waits for the other. Values the reader didn't get to are skipped.
+#pragma once
+#include <atomic>
+
+template <typename T>
+class TripleBuffer {
+  public:
+    TripleBuffer() : back(0), middle(1), front(2) {}
+
+    // Writer
+    T &getWriteBuffer() { return buffers[back]; }
+    void publish() {
+      back = middle.exchange(back | freshBit, std::memory_order_acq_rel) & indexMask;
+    }
+
+    // Reader. Returns true if there was something new to swap in.
+    bool update() {
+      if ((middle.load(std::memory_order_acquire) & freshBit) == 0) {
+        return false;
+      }
+      front = middle.exchange(front, std::memory_order_acq_rel) & indexMask;
+      return true;
+    }
+    const T &getReadBuffer() const { return buffers[front]; }
+
+  private:
+    static const int indexMask = 3;
+    static const int freshBit = 4; // Set on the middle index when it holds a value the reader hasn't seen.
+
+    T buffers[3];
+    int back; // Writer's
+    std::atomic<int> middle; // Last published.
+    int front; // Reader's
+};
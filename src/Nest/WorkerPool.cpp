@@ -0,0 +1,86 @@
+#include "WorkerPool.h"
+
+WorkerPool::~WorkerPool() {
+  stop();
+}
+
+void WorkerPool::setup(int numThreads) {
+  if (numThreads <= 0) {
+    numThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  stop();
+  // A worker only waits for jobs after the one it's started at, however late its thread
+  // gets going, so a parallelFor right after this can't be missed.
+  std::lock_guard<std::mutex> lock(mutex);
+  isExiting = false;
+  for (int i = 0; i < numThreads - 1; i++) {
+    workers.emplace_back(&WorkerPool::work, this, generation);
+  }
+}
+
+void WorkerPool::stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    isExiting = true;
+  }
+  wake.notify_all();
+  for (auto &w : workers) {
+    w.join();
+  }
+  workers.clear();
+}
+
+void WorkerPool::parallelFor(int count, const std::function<void(int)> &fn) {
+  // Not worth waking anybody up.
+  if (workers.empty() || count < 2) {
+    for (int i = 0; i < count; i++) {
+      fn(i);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    job = &fn;
+    jobCount = count;
+    nextIdx = 0;
+    numBusy = workers.size();
+    generation++;
+  }
+  wake.notify_all();
+
+  runJobs();
+
+  // Every worker has to see this job before the next one can start.
+  std::unique_lock<std::mutex> lock(mutex);
+  done.wait(lock, [&] { return numBusy == 0; });
+  job = NULL;
+}
+
+void WorkerPool::work(int seen) {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    wake.wait(lock, [&] { return isExiting || generation != seen; });
+    if (isExiting) {
+      return;
+    }
+    seen = generation;
+
+    lock.unlock();
+    runJobs();
+    lock.lock();
+
+    numBusy--;
+    if (numBusy == 0) {
+      done.notify_one();
+    }
+  }
+}
+
+void WorkerPool::runJobs() {
+  int i;
+  while ((i = nextIdx.fetch_add(1)) < jobCount) {
+    (*job)(i);
+  }
+}
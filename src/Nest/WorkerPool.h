@@ -0,0 +1,33 @@
+// A few threads that run a loop body for every index, with the calling thread helping out.
+// The work must only touch what belongs to its own index; the order isn't defined.
+#pragma once
+#include "ofMain.h"
+
+class WorkerPool {
+  public:
+    ~WorkerPool();
+
+    // 0 uses every core, 1 runs everything on the calling thread.
+    void setup(int numThreads);
+    int getNumThreads() const { return workers.size() + 1; }
+
+    // Calls fn(i) for i in [0, count) and returns when all of them are done.
+    void parallelFor(int count, const std::function<void(int)> &fn);
+
+  private:
+    void work(int seen); // seen: the generation when it was started.
+    void runJobs();
+    void stop();
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake; // New job or exit.
+    std::condition_variable done; // Every worker finished the job.
+
+    const std::function<void(int)> *job = NULL;
+    int jobCount = 0;
+    std::atomic<int> nextIdx { 0 };
+    int numBusy = 0;
+    int generation = 0; // Bumped for every job.
+    bool isExiting = false;
+};
@@ -0,0 +1,85 @@
+#include "AgentSkin.h"
+
+// ------------------------------ Message --------------------------------------- //
+Message::Message(glm::vec2 loc, ofColor col, float s) {
+  location = loc;
+  color = col;
+  size = s;
+}
+
+void Message::draw() {
+  ofPushMatrix();
+    ofTranslate(location);
+      ofPushStyle();
+        ofColor c = ofColor(color, 250);
+        ofSetColor(c);
+        ofDrawCircle(0, 0, size);
+      ofPopStyle();
+  ofPopMatrix();
+}
+
+// ------------------------------ AgentSkin --------------------------------------- //
+
+void AgentSkin::setup(const std::vector<ofColor> &palette, ofPoint textureSize) {
+  // ACTIVE filter
+  filter = std::make_shared<PerlinPixellationFilter>(textureSize.x, textureSize.y, 15.f);
+
+  // Create spots on the agent's body
+  messages.clear();
+  for (int i = 0; i < numMessages; i++) {
+    // Pick a random location on the mesh.
+    int w = textureSize.x; int h = textureSize.y;
+    auto x = ofRandom(0, w); auto y = ofRandom(0, h);
+
+    // Pick a random color for the message (anything except the background)
+    int idx = ofRandom(1, palette.size());
+    ofColor c = ofColor(palette.at(idx));
+
+    // Pick a random size (TOOD: Based off on the length of the message).
+    int size = ofRandom(10, 15);
+
+    // Create a message.
+    Message m = Message(glm::vec2(x, y), c, size);
+    messages.push_back(m);
+  }
+
+  // Create 1st fbo and draw all the messages.
+  firstFbo.allocate(textureSize.x*2, textureSize.y*2, GL_RGBA);
+  firstFbo.begin();
+    ofClear(0, 0, 0, 0);
+
+    // Assign background.
+    int randIdx = ofRandom(palette.size());
+    ofColor c = ofColor(palette.at(randIdx), 250);
+    ofBackground(c);
+
+    // Draw assigned messages.
+    for (auto m : messages) {
+      m.draw();
+    }
+
+  firstFbo.end();
+
+  if (firstFbo.isAllocated()) {
+    // Create 2nd fbo and draw with filter and postProcessing
+    secondFbo.allocate(textureSize.x, textureSize.y, GL_RGBA);
+    secondFbo.begin();
+      ofClear(0, 0, 0, 0);
+      filter->begin();
+        firstFbo.getTexture().drawSubsection(0, 0, textureSize.x, textureSize.y, 0, 0);
+      filter->end();
+    secondFbo.end();
+  }
+}
+
+bool AgentSkin::isAllocated() {
+  return secondFbo.isAllocated();
+}
+
+ofTexture &AgentSkin::getTexture() {
+  return secondFbo.getTexture();
+}
+
+ofPoint AgentSkin::getSize() {
+  return ofPoint(secondFbo.getWidth(), secondFbo.getHeight());
+}
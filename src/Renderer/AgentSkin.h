@@ -0,0 +1,35 @@
+// The texture an agent wears. It needs a GL context, so it's created by the renderer
+// (on the GL thread) from the agent's palette, never by the simulation.
+#pragma once
+#include "ofMain.h"
+#include "ofxFilterLibrary.h"
+
+// Every agent is inscribed with certain messages. Right now they are just
+// used to create a texture for the agent. They might be used as certain
+// communicative elements between messages. Not sure what it could be but
+// could be something interesting.
+class Message {
+  public:
+    Message(glm::vec2 loc, ofColor col, float size);
+    void draw();
+
+    glm::vec2 location;
+    ofColor color;
+    float size;
+};
+
+class AgentSkin {
+  public:
+    void setup(const std::vector<ofColor> &palette, ofPoint textureSize);
+    bool isAllocated();
+    ofTexture &getTexture();
+    ofPoint getSize();
+
+    std::vector<Message> messages;
+
+  private:
+    int numMessages = 100; // Number of messages each agent has
+    std::shared_ptr<AbstractFilter> filter;
+    ofFbo firstFbo;
+    ofFbo secondFbo;
+};
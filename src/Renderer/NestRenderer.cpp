@@ -0,0 +1,95 @@
+#include "NestRenderer.h"
+
+void NestRenderer::draw(const NestSnapshot &snapshot, bool showVisibilityRadius, bool showTexture) {
+  updateViews(snapshot);
+
+  // Draw all the interAgent joints.
+  jointMesh.setMode(OF_PRIMITIVE_LINES);
+  auto &lines = jointMesh.getVertices();
+  lines.assign(snapshot.jointLines.begin(), snapshot.jointLines.end());
+  ofPushStyle();
+    ofSetColor(ofColor::red);
+    jointMesh.draw();
+  ofPopStyle();
+
+  for (auto &a : snapshot.agents) {
+    drawAgent(snapshot, a, showVisibilityRadius, showTexture);
+  }
+
+  // Draw broken bonds and exploded agents.
+  ofPushStyle();
+    for (auto &m : snapshot.memories) {
+      ofSetColor(m.color);
+      ofDrawCircle(m.position, m.radius);
+    }
+  ofPopStyle();
+}
+
+void NestRenderer::clear() {
+  views.clear();
+}
+
+void NestRenderer::drawAgent(const NestSnapshot &snapshot, const AgentSnapshot &agent, bool showVisibilityRadius, bool showTexture) {
+  auto &view = views[agent.id];
+  auto &points = view.mesh.getVertices();
+  if (points.size() != (size_t) agent.numVertices) {
+    return;
+  }
+  std::copy(snapshot.vertices.begin() + agent.firstVertex, snapshot.vertices.begin() + agent.firstVertex + agent.numVertices, points.begin());
+
+  // Draw the mesh vertices as soft bodies
+  glPointSize(agent.shape->vertexRadius*2);
+  ofPushStyle();
+    ofSetColor(ofColor::red);
+    view.mesh.draw(OF_MESH_POINTS);
+  ofPopStyle();
+
+  if (view.skin.isAllocated()) {
+    if (showTexture) {
+      view.skin.getTexture().bind();
+        view.mesh.draw();
+      view.skin.getTexture().unbind();
+    } else {
+      ofPushStyle();
+        ofSetColor(ofColor::green);
+        view.mesh.drawWireframe();
+      ofPopStyle();
+    }
+  }
+
+  if (showVisibilityRadius) {
+    ofPushStyle();
+      ofNoFill();
+      ofSetColor(ofColor::yellow);
+      ofDrawCircle(agent.centroid, agent.visibilityRadius);
+    ofPopStyle();
+  }
+}
+
+void NestRenderer::updateViews(const NestSnapshot &snapshot) {
+  for (auto &v : views) {
+    v.second.isSeen = false;
+  }
+
+  for (auto &a : snapshot.agents) {
+    auto it = views.find(a.id);
+    if (it == views.end()) {
+      // New agent, skin it.
+      auto &view = views[a.id];
+      view.mesh = a.shape->mesh;
+      view.skin.setup(a.shape->palette, a.shape->textureSize);
+      view.isSeen = true;
+    } else {
+      it->second.isSeen = true;
+    }
+  }
+
+  // Exploded or cleared.
+  for (auto it = views.begin(); it != views.end();) {
+    if (!it->second.isSeen) {
+      it = views.erase(it);
+    } else {
+      it++;
+    }
+  }
+}
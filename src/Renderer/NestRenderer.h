@@ -0,0 +1,25 @@
+// Draws the nest from its snapshots. Everything that needs the GL context lives here,
+// like the agents' textures, which are made the first time an agent shows up.
+#pragma once
+#include "ofMain.h"
+#include "NestSnapshot.h"
+#include "AgentSkin.h"
+
+class NestRenderer {
+  public:
+    void draw(const NestSnapshot &snapshot, bool showVisibilityRadius, bool showTexture);
+    void clear();
+
+  private:
+    struct AgentView {
+      AgentSkin skin;
+      ofMesh mesh; // Agent's shape with the snapshot's vertices.
+      bool isSeen; // In the last snapshot.
+    };
+
+    void drawAgent(const NestSnapshot &snapshot, const AgentSnapshot &agent, bool showVisibilityRadius, bool showTexture);
+    void updateViews(const NestSnapshot &snapshot); // Create new ones, forget the gone ones.
+
+    std::map<int, AgentView> views; // Agent id => view.
+    ofMesh jointMesh;
+};
@@ -0,0 +1,40 @@
+#include "AudienceFrame.h"
+
+void AudienceFrame::mergeDuplicates(float distance) {
+  auto distanceSq = distance * distance;
+  weights.assign(points.size(), 1);
+  merged.resize(points.size());
+  
+  // Compacts in place, [0, kept) are the points so far.
+  int kept = 0;
+  for (int i = 0; i < points.size(); i++) {
+    uint64_t source = 1ull << sources[i];
+    int nearest = -1; float nearestSq = distanceSq;
+    for (int j = 0; j < kept; j++) {
+      auto delta = points[j] - points[i];
+      auto d = glm::dot(delta, delta);
+      // A source sees a person once, so one it already went into is somebody else.
+      if (!(merged[j] & source) && d < nearestSq) {
+        nearest = j; nearestSq = d;
+      }
+    }
+    
+    if (nearest >= 0) {
+      // Running average of everybody merged into it.
+      auto &w = weights[nearest];
+      points[nearest] = (points[nearest] * (float) w + points[i]) / (float) (w + 1);
+      w++;
+      merged[nearest] |= source;
+    } else {
+      points[kept] = points[i];
+      ids[kept] = ids[i];
+      sources[kept] = sources[i];
+      weights[kept] = 1;
+      merged[kept] = source;
+      kept++;
+    }
+  }
+  points.resize(kept);
+  ids.resize(kept);
+  sources.resize(kept);
+}
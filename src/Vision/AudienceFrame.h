@@ -0,0 +1,30 @@
+// Who's in the room as the nest sees them. Kinect makes one every update from the
+// latest PeopleFrame of every source, in screen space and predicted to when it's made,
+// and everybody downstream reads that one by reference.
+#pragma once
+#include "ofMain.h"
+#include "OccupancyGrid.h"
+
+struct AudienceFrame {
+  std::vector<glm::vec2> points; // Screen.
+  std::vector<unsigned int> ids; // Source << 24 | tracker label of every point.
+  std::vector<int> sources; // Kinect every point came from.
+  OccupancyGrid occupancy; // Their silhouettes, not set up when that's off.
+  uint64_t timestamp = 0; // Capture of the oldest depth frame (us, ofGetElapsedTimeMicros).
+  uint64_t time = 0; // When this was made, the points are predicted to it (us).
+  float processingTime = 0; // ms, depth frame to people, the slowest source.
+  uint64_t frameIdx = 0; // Of the depth frame.
+
+  // How old the sensor data behind the points is (ms).
+  float getAge() const { return time > timestamp ? (time - timestamp) / 1000.0 : 0; }
+
+  // Where the sources overlap, the same person is seen by more than one of them. Points
+  // of different sources closer than distance become one, at their average, with the
+  // id of the first. A point never takes two points of the same source, so two people
+  // standing close stay two. Up to 64 sources.
+  void mergeDuplicates(float distance);
+
+  private:
+    std::vector<int> weights; // Scratch, points merged into every point.
+    std::vector<uint64_t> merged; // Scratch, bit per source merged into every point.
+};
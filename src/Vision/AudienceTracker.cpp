@@ -0,0 +1,41 @@
+#include "AudienceTracker.h"
+
+void AudienceTracker::update(PeopleFrame &frame, float smoothing) {
+  for (auto &blob : frame.blobs) {
+    auto it = tracks.find(blob.label);
+    if (it == tracks.end()) {
+      // Just walked in.
+      tracks[blob.label] = { blob.centroid, glm::vec2(0, 0), frame.timestamp, frame.frameIdx };
+      blob.velocity = glm::vec2(0, 0);
+      continue;
+    }
+
+    auto &track = it->second;
+    if (frame.timestamp > track.timestamp) {
+      float dt = (frame.timestamp - track.timestamp) / 1000000.0;
+      auto velocity = (blob.centroid - track.position) / dt;
+      track.velocity = velocity + (track.velocity - velocity) * smoothing;
+      track.position = blob.centroid;
+      track.timestamp = frame.timestamp;
+    }
+    track.frameIdx = frame.frameIdx;
+    blob.velocity = track.velocity;
+  }
+
+  // Labels the contour tracker let go of.
+  for (auto it = tracks.begin(); it != tracks.end();) {
+    if (it->second.frameIdx != frame.frameIdx) {
+      it = tracks.erase(it);
+    } else {
+      it++;
+    }
+  }
+}
+
+glm::vec2 AudienceTracker::predict(const PeopleBlob &blob, uint64_t timestamp, uint64_t time, uint64_t maxLead) {
+  if (time <= timestamp) {
+    return blob.centroid;
+  }
+  float lead = std::min(time - timestamp, maxLead) / 1000000.0;
+  return blob.centroid + blob.velocity * lead;
+}
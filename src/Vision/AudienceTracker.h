@@ -0,0 +1,27 @@
+// Follows the people the contour tracker labels from frame to frame and gives them a
+// velocity, so where they are can be predicted past the frame they were seen in. By the
+// time a depth frame is drawn, it's a sensor frame and its processing old, and somebody
+// walking is a good few centimetres further along.
+#pragma once
+#include "ofMain.h"
+#include "DepthFrame.h"
+
+class AudienceTracker {
+  public:
+    // Sets the velocity of every blob from where its label was in the frames before.
+    // smoothing: how much of the old velocity is kept, 0: just the last step.
+    void update(PeopleFrame &frame, float smoothing);
+
+    // Constant velocity from the frame (timestamp, us) to time (us), at most maxLead (us)
+    // ahead so a stalled sensor doesn't fling anybody across the room.
+    static glm::vec2 predict(const PeopleBlob &blob, uint64_t timestamp, uint64_t time, uint64_t maxLead);
+
+  private:
+    struct Track {
+      glm::vec2 position;
+      glm::vec2 velocity;
+      uint64_t timestamp;
+      uint64_t frameIdx; // Last frame the label was in.
+    };
+    std::unordered_map<unsigned int, Track> tracks; // By label.
+};
@@ -0,0 +1,60 @@
+#include "DepthBackground.h"
+
+const ofShortPixels &DepthBackground::apply(const ofShortPixels &raw, const ofPixels &mask, const DepthSettings &settings) {
+  size_t w = raw.getWidth(); size_t h = raw.getHeight();
+  if (foreground.getWidth() != w || foreground.getHeight() != h) {
+    foreground.allocate(w, h, OF_PIXELS_GRAY);
+    reset();
+  }
+
+  if (learnedFrames < settings.backgroundInterval) {
+    // To begin with, the average of every frame, so one noisy reading doesn't stick.
+    learn(raw, ofPixels(), std::max(1.0f / (learnedFrames + 1), settings.backgroundRate), settings.backgroundThreshold);
+    learnedFrames++;
+    framesSinceLearn = 0;
+  } else if (++framesSinceLearn >= settings.backgroundInterval) {
+    bool hasMask = mask.getWidth() == w && mask.getHeight() == h;
+    learn(raw, hasMask ? mask : ofPixels(), settings.backgroundRate, settings.backgroundThreshold);
+    framesSinceLearn = 0;
+  }
+
+  // Foreground: a reading closer than the background's limit.
+  auto src = raw.getData(); auto dst = foreground.getData(); auto limit = limits.data();
+  size_t size = w * h;
+  for (size_t i = 0; i < size; i++) {
+    unsigned short d = src[i];
+    dst[i] = (d != 0) & (d < limit[i]) ? d : 65535;
+  }
+  return foreground;
+}
+
+void DepthBackground::reset() {
+  model.clear();
+  limits.clear();
+  learnedFrames = 0;
+  framesSinceLearn = 0;
+}
+
+void DepthBackground::learn(const ofShortPixels &raw, const ofPixels &mask, float rate, float threshold) {
+  size_t size = raw.size();
+  auto src = raw.getData();
+  if (model.size() != size) {
+    model.assign(size, 0);
+    limits.assign(size, 0);
+  }
+
+  // No reading says nothing about the background. A pixel that never had one knows no
+  // background, so any reading there is foreground, and it takes the first reading it
+  // gets outside the mask. Nobody in the mask means every pixel learns.
+  auto m = model.data(); auto limit = limits.data();
+  auto people = mask.isAllocated() ? mask.getData() : NULL;
+  for (size_t i = 0; i < size; i++) {
+    float d = src[i];
+    float r = m[i] == 0 ? 1 : rate;
+    if (d == 0 || (people && people[i])) {
+      r = 0;
+    }
+    m[i] += (d - m[i]) * r;
+    limit[i] = m[i] == 0 ? 65535 : ofClamp(m[i] - threshold, 0.0f, 65535.0f);
+  }
+}
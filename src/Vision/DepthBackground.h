@@ -0,0 +1,32 @@
+// Per pixel background depth, learned as a running average of the frames. Whatever isn't
+// closer than the background (the floor, the walls, the sculpture in the middle of the
+// room) is pushed out of range before DepthMask sees the frame, so the mask only needs
+// the morphology for the sensor noise, not for the room.
+// - Learning is slow on purpose: every interval'th frame, by rate, and only where the
+//   last frame's mask had nobody, so people standing still don't fade into it.
+// - Where it never had a reading, there's no background yet and every reading is
+//   foreground, until one comes in outside the mask.
+// - Every frame is one subtract and compare per pixel against a 16 bit limit made when
+//   it learns, in a loop without branches that vectorises.
+// The first interval frames are averaged into the background to begin with, so it's best
+// turned on with nobody in the room. Turning it off forgets it.
+#pragma once
+#include "ofMain.h"
+#include "DepthFrame.h"
+
+class DepthBackground {
+  public:
+    // raw with everything that isn't foreground at the far end of the range (65535 mm).
+    // mask: the people last frame, 0 or 255, not allocated if there's nothing yet.
+    const ofShortPixels &apply(const ofShortPixels &raw, const ofPixels &mask, const DepthSettings &settings);
+    void reset();
+
+  private:
+    void learn(const ofShortPixels &raw, const ofPixels &mask, float rate, float threshold);
+
+    std::vector<float> model; // mm, 0: never had a reading.
+    std::vector<unsigned short> limits; // Closer than this is foreground (mm).
+    ofShortPixels foreground;
+    int learnedFrames = 0;
+    int framesSinceLearn = 0;
+};
@@ -0,0 +1,79 @@
+#include "DepthCalibration.h"
+#include "ofxCv.h"
+
+bool DepthCalibration::load(std::string path) {
+  if (!ofFile::doesFileExist(path)) {
+    return false;
+  }
+  auto json = ofLoadJson(path);
+  if (!json.count("homography") || json["homography"].size() != 9) {
+    ofLogError("DepthCalibration") << "No homography in " << path;
+    return false;
+  }
+  for (int i = 0; i < 9; i++) {
+    homography[i] = json["homography"][i].get<double>();
+  }
+  pairs.clear();
+  for (auto &p : json["pairs"]) {
+    pairs.push_back({ glm::vec2(p[0].get<float>(), p[1].get<float>()), glm::vec2(p[2].get<float>(), p[3].get<float>()) });
+  }
+  calibrated = true;
+  ofLog() << "Loaded the Kinect calibration from " << path << endl;
+  return true;
+}
+
+void DepthCalibration::save(std::string path) {
+  if (!calibrated) {
+    return;
+  }
+  ofJson json;
+  for (int i = 0; i < 9; i++) {
+    json["homography"].push_back(homography[i]);
+  }
+  json["pairs"] = ofJson::array();
+  for (auto &p : pairs) {
+    json["pairs"].push_back({ p.depth.x, p.depth.y, p.screen.x, p.screen.y });
+  }
+  ofSavePrettyJson(path, json);
+}
+
+void DepthCalibration::addPair(glm::vec2 depth, glm::vec2 screen) {
+  pairs.push_back({ depth, screen });
+}
+
+void DepthCalibration::removeLastPair() {
+  if (pairs.size() > 0) {
+    pairs.pop_back();
+  }
+}
+
+void DepthCalibration::clearPairs() {
+  pairs.clear();
+}
+
+bool DepthCalibration::fit() {
+  if (pairs.size() < 4) {
+    return false;
+  }
+  std::vector<cv::Point2f> src, dst;
+  for (auto &p : pairs) {
+    src.push_back(cv::Point2f(p.depth.x, p.depth.y));
+    dst.push_back(cv::Point2f(p.screen.x, p.screen.y));
+  }
+  cv::Mat h = cv::findHomography(src, dst);
+  if (h.empty()) {
+    ofLogWarning("DepthCalibration") << "Can't fit the " << pairs.size() << " pairs, are 3 of them on a line?";
+    return false;
+  }
+  for (int i = 0; i < 9; i++) {
+    homography[i] = h.at<double>(i / 3, i % 3);
+  }
+  calibrated = true;
+  return true;
+}
+
+glm::vec2 DepthCalibration::map(glm::vec2 p) const {
+  auto &h = homography;
+  double w = h[6] * p.x + h[7] * p.y + h[8];
+  return glm::vec2((h[0] * p.x + h[1] * p.y + h[2]) / w, (h[3] * p.x + h[4] * p.y + h[5]) / w);
+}
@@ -0,0 +1,31 @@
+// Maps depth image points onto the screen with a homography fit to point pairs clicked
+// during the install, so the audience lines up with the projection however the Kinect
+// and the projector are placed. Only the few people points go through it, never pixels.
+#pragma once
+#include "ofMain.h"
+
+struct CalibrationPair {
+  glm::vec2 depth; // Depth image pixels.
+  glm::vec2 screen; // 0..1 of the screen, so it holds at any window size.
+};
+
+class DepthCalibration {
+  public:
+    bool load(std::string path); // Relative to the data folder.
+    void save(std::string path);
+
+    void addPair(glm::vec2 depth, glm::vec2 screen);
+    void removeLastPair();
+    void clearPairs(); // The last fit stays until the next one.
+    const std::vector<CalibrationPair> &getPairs() const { return pairs; }
+
+    // Least squares fit to all the pairs, needs at least 4. Keeps the last fit if it fails.
+    bool fit();
+    bool isCalibrated() const { return calibrated; }
+    glm::vec2 map(glm::vec2 depth) const; // To 0..1 of the screen.
+
+  private:
+    std::vector<CalibrationPair> pairs;
+    double homography[9]; // Row major.
+    bool calibrated = false;
+};
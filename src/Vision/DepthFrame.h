@@ -0,0 +1,54 @@
+// What goes in and out of the depth pipeline. A DepthFrame is one raw frame from a
+// sensor, a PeopleFrame is what the pipeline found in it with the DepthSettings.
+#pragma once
+#include "ofMain.h"
+
+struct DepthFrame {
+  ofShortPixels depth; // mm, 0: no reading.
+  uint64_t timestamp = 0; // Capture time (us, ofGetElapsedTimeMicros).
+};
+
+// A person found in the depth image.
+struct PeopleBlob {
+  glm::vec2 centroid; // Depth image pixels.
+  glm::vec2 velocity; // Depth image pixels per second, see AudienceTracker.
+  ofPolyline contour;
+  unsigned int label; // Contour tracker label, the same person for as long as they're tracked.
+  int age; // Frames the tracker has seen this label.
+};
+
+struct PeopleFrame {
+  std::vector<PeopleBlob> blobs;
+  ofPixels depth; // 8 bit depth the blobs were found in, before any filtering but the background.
+  uint64_t timestamp = 0; // Of the DepthFrame.
+  float processingTime = 0; // ms
+  uint64_t frameIdx = 0; // Counts the frames the pipeline processed.
+  bool isFullScan = true; // Else the mask is only refined in the regions.
+  std::vector<ofRectangle> regions; // Depth image pixels.
+  float coverage = 1; // Of the image, refined at full resolution.
+};
+
+// Copied out of the Kinect GUI, so the processing never reads a parameter the GUI is writing.
+struct DepthSettings {
+  float minDistance = 500; // mm, maps to 255.
+  float maxDistance = 6000; // mm, maps to 0.
+  float blur = 0;
+  int erosion = 0;
+  int dilation = 0;
+  int imageThreshold = 128;
+  float minArea = 10; // Contour radius.
+  float maxArea = 200;
+  int contourThreshold = 128;
+  // People are found on this pyramid level (1/2^level of the resolution) and only the
+  // regions around them, and around who we tracked last frame, get the full resolution
+  // mask. 0: always the whole frame.
+  int pyramidLevel = 2;
+  int rescanInterval = 30; // Frames between whole frame scans, for anybody the pyramid missed.
+  int regionPadding = 10; // px
+  float velocitySmoothing = 0.5; // Of the tracked velocities, 0: the last frame's motion only.
+  // Only what's closer than the learned background is foreground, see DepthBackground.
+  bool background = false;
+  float backgroundThreshold = 150; // mm closer than the background.
+  float backgroundRate = 0.05; // Of the new frame, every time it learns.
+  int backgroundInterval = 15; // Frames between learning.
+};
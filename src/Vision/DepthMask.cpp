@@ -0,0 +1,146 @@
+#include "DepthMask.h"
+#include "ofxCv.h"
+
+void DepthMask::process(const ofShortPixels &raw, const DepthSettings &settings, ofPixels &depth, ofPixels &mask) {
+  size_t w = raw.getWidth(); size_t h = raw.getHeight();
+  if (depth.getWidth() != w || depth.getHeight() != h) {
+    depth.allocate(w, h, OF_PIXELS_GRAY);
+  }
+  if (mask.getWidth() != w || mask.getHeight() != h) {
+    mask.allocate(w, h, OF_PIXELS_GRAY);
+  }
+  process(raw.getData(), w, h, settings, depth.getData(), mask.getData());
+}
+
+void DepthMask::process(const unsigned short *raw, int w, int h, const DepthSettings &settings, unsigned char *depth, unsigned char *mask) {
+  updateLuts(settings);
+
+  // One pass: depth and mask.
+  int blurSize = ofxCv::forceOdd(settings.blur);
+  if (blurSize <= 1) {
+    for (int i = 0; i < w * h; i++) {
+      auto d = depthLut[raw[i]];
+      depth[i] = d;
+      mask[i] = thresholdLut[d];
+    }
+  } else {
+    for (int i = 0; i < w * h; i++) {
+      depth[i] = depthLut[raw[i]];
+    }
+    cv::Mat depthMat(h, w, CV_8UC1, depth); cv::Mat maskMat(h, w, CV_8UC1, mask);
+    cv::blur(depthMat, maskMat, cv::Size(blurSize, blurSize)); // As ofxCv::blur
+    for (int i = 0; i < w * h; i++) {
+      mask[i] = thresholdLut[mask[i]];
+    }
+  }
+
+  morph(mask, w, h, settings.erosion, settings.dilation);
+}
+
+void DepthMask::mapDepth(const unsigned short *raw, int size, const DepthSettings &settings, unsigned char *depth) {
+  updateLuts(settings);
+  for (int i = 0; i < size; i++) {
+    depth[i] = depthLut[raw[i]];
+  }
+}
+
+int DepthMask::getReach(const DepthSettings &settings) {
+  return std::max(settings.erosion, 0) + std::max(settings.dilation, 0) + ofxCv::forceOdd(settings.blur) / 2;
+}
+
+void DepthMask::updateLuts(const DepthSettings &settings) {
+  if (settings.minDistance != lutMinDistance || settings.maxDistance != lutMaxDistance) {
+    depthLut.resize(65536);
+    for (int i = 0; i < 65536; i++) {
+      depthLut[i] = ofMap(i, settings.minDistance, settings.maxDistance, 255, 0, true); // As DepthProcessor::mapDepth
+    }
+    lutMinDistance = settings.minDistance;
+    lutMaxDistance = settings.maxDistance;
+  }
+
+  if (settings.imageThreshold != lutThreshold) {
+    for (int i = 0; i < 256; i++) {
+      thresholdLut[i] = i > settings.imageThreshold ? 255 : 0; // cv::THRESH_BINARY
+    }
+    lutThreshold = settings.imageThreshold;
+  }
+}
+
+// Min for erode, max for dilate.
+template <bool isErode>
+static inline unsigned char pick(unsigned char a, unsigned char b) {
+  return isErode ? std::min(a, b) : std::max(a, b);
+}
+
+// Blocks, so both sides stay in the cache.
+static void transpose(const unsigned char *src, int w, int h, unsigned char *dst) {
+  const int block = 32;
+  for (int by = 0; by < h; by += block) {
+    for (int bx = 0; bx < w; bx += block) {
+      int maxY = std::min(by + block, h); int maxX = std::min(bx + block, w);
+      for (int y = by; y < maxY; y++) {
+        for (int x = bx; x < maxX; x++) {
+          dst[x * h + y] = src[y * w + x];
+        }
+      }
+    }
+  }
+}
+
+// Column filters commute with row filters, so erode then dilate is: erode the
+// columns, transpose, erode and dilate the rows (now columns), transpose back and
+// dilate the columns. Every pass runs down the columns, a whole row at a time.
+void DepthMask::morph(unsigned char *data, int w, int h, int erosion, int dilation) {
+  if (erosion <= 0 && dilation <= 0) {
+    return;
+  }
+  transposed.resize(w * h);
+
+  morphColumns<true>(data, w, h, erosion);
+  transpose(data, w, h, transposed.data());
+  morphColumns<true>(transposed.data(), h, w, erosion);
+  morphColumns<false>(transposed.data(), h, w, dilation);
+  transpose(transposed.data(), h, w, data);
+  morphColumns<false>(data, w, h, dilation);
+}
+
+// Window of 2r+1 rows over the image padded with r neutral rows on both sides (and to
+// a multiple of the window). Within every block of the window's size, prefix[i] is the
+// min from the block start to row i and suffix[i] from row i to the block end. The
+// window starting at i covers the end of one block and the start of the next:
+// out[i] = min(suffix[i], prefix[i + 2r]). 3 comparisons per pixel, whatever r is.
+template <bool isErode>
+void DepthMask::morphColumns(unsigned char *data, int w, int h, int r) {
+  if (r <= 0) {
+    return;
+  }
+  int size = 2 * r + 1;
+  int n = ((h + 2 * r + size - 1) / size) * size;
+  const unsigned char neutral = isErode ? 255 : 0; // Outside the image doesn't count.
+  padded.assign(n * w, neutral);
+  prefix.resize(n * w);
+  suffix.resize(n * w);
+
+  std::copy(data, data + w * h, padded.begin() + r * w);
+  auto pad = padded.data(); auto pre = prefix.data(); auto suf = suffix.data();
+
+  for (int b = 0; b < n; b += size) {
+    std::copy(pad + b * w, pad + (b + 1) * w, pre + b * w);
+    std::copy(pad + (b + size - 1) * w, pad + (b + size) * w, suf + (b + size - 1) * w);
+    for (int i = 1; i < size; i++) {
+      auto p = pad + (b + i) * w; auto lastP = pre + (b + i - 1) * w; auto curP = pre + (b + i) * w;
+      auto s = pad + (b + size - 1 - i) * w; auto lastS = suf + (b + size - i) * w; auto curS = suf + (b + size - 1 - i) * w;
+      for (int x = 0; x < w; x++) {
+        curP[x] = pick<isErode>(lastP[x], p[x]);
+        curS[x] = pick<isErode>(lastS[x], s[x]);
+      }
+    }
+  }
+
+  for (int y = 0; y < h; y++) {
+    auto s = suf + y * w; auto p = pre + (y + 2 * r) * w; auto row = data + y * w;
+    for (int x = 0; x < w; x++) {
+      row[x] = pick<isErode>(s[x], p[x]);
+    }
+  }
+}
@@ -0,0 +1,48 @@
+// Raw depth to the binary mask the contours are found in. Gives the same mask as
+// mapping the range to 8 bits and then ofxCv blur, erode, dilate and threshold, in
+// fewer passes and without allocating once the buffers are there:
+// - Range mapping and threshold are one lookup per pixel. The threshold can go first
+//   since erode and dilate (min and max) don't change the order of the values.
+// - Erode and dilate are square min/max filters, like OpenCV's 3x3 rect kernel
+//   repeated, done separably with van Herk/Gil-Werman. That's 3 comparisons per pixel
+//   and direction, whatever the size. Rows are filtered as the columns of the
+//   transposed mask, so every pass runs over whole rows and vectorises.
+// - A blur of more than 1 pixel goes through ofxCv, so the rounding stays OpenCV's.
+// Bit exact with that chain on the same 16 bit depth. The Kinect gives float mm, which
+// ofxKinectV2 mapped to 8 bits directly, and KinectSource rounds to whole mm first. That
+// moves a pixel by at most 0.5 mm, so its 8 bit depth by at most one level, and only
+// when the rounding crosses a level's edge (levels are (max - min) / 255 mm, about 2% of
+// the pixels at the show's range). The mask only changes where such a pixel is within
+// 0.5 mm of the threshold depth, and as far around it as blur, erode and dilate reach.
+#pragma once
+#include "ofMain.h"
+#include "DepthFrame.h"
+
+class DepthMask {
+  public:
+    // depth: the 8 bit range mapped depth (as DepthProcessor::mapDepth), mask: 0 or 255.
+    void process(const ofShortPixels &raw, const DepthSettings &settings, ofPixels &depth, ofPixels &mask);
+    void process(const unsigned short *raw, int w, int h, const DepthSettings &settings, unsigned char *depth, unsigned char *mask);
+
+    // Just the depth, for all of a frame when only parts of it get a mask.
+    void mapDepth(const unsigned short *raw, int size, const DepthSettings &settings, unsigned char *depth);
+
+    // How far (px) the depth around a pixel decides its mask value.
+    static int getReach(const DepthSettings &settings);
+
+  private:
+    void updateLuts(const DepthSettings &settings);
+
+    // Square min (erode), then max (dilate) filter of these radii. Outside the image
+    // doesn't count, like OpenCV's default morphology border.
+    void morph(unsigned char *mask, int w, int h, int erosion, int dilation);
+    template <bool isErode> void morphColumns(unsigned char *data, int w, int h, int r);
+
+    // Raw depth (mm) to 8 bit depth, 8 bit depth to the mask.
+    std::vector<unsigned char> depthLut;
+    unsigned char thresholdLut[256];
+    float lutMinDistance = -1; float lutMaxDistance = -1; int lutThreshold = -1;
+
+    // van Herk/Gil-Werman scratch.
+    std::vector<unsigned char> padded, prefix, suffix, transposed;
+};
@@ -0,0 +1,54 @@
+#include "DepthPipeline.h"
+
+void DepthPipeline::start() {
+  startThread();
+}
+
+void DepthPipeline::stop() {
+  if (isThreadRunning()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex); // So the thread can't miss the wake up.
+      stopThread();
+    }
+    hasInput.notify_all();
+    waitForThread(false);
+  }
+}
+
+void DepthPipeline::setSettings(const DepthSettings &s) {
+  std::lock_guard<std::mutex> lock(mutex);
+  settings = s;
+}
+
+void DepthPipeline::push(DepthFrame &frame) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::swap(pending, frame);
+    isPending = true;
+  }
+  hasInput.notify_one();
+}
+
+bool DepthPipeline::update() {
+  return frames.update();
+}
+
+void DepthPipeline::threadedFunction() {
+  DepthFrame input;
+  DepthSettings curSettings;
+  while (isThreadRunning()) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      hasInput.wait(lock, [&] { return isPending || !isThreadRunning(); });
+      if (!isThreadRunning()) {
+        break;
+      }
+      std::swap(pending, input);
+      isPending = false;
+      curSettings = settings;
+    }
+
+    processor.process(input, curSettings, frames.getWriteBuffer());
+    frames.publish();
+  }
+}
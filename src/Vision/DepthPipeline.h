@@ -0,0 +1,34 @@
+// Runs the DepthProcessor on its own thread. Sensors push raw frames in, the newest one
+// wins if the thread is still busy. Every processed frame is published as a PeopleFrame
+// the main thread reads without locking, so rendering never waits on OpenCV.
+#pragma once
+#include "ofMain.h"
+#include "DepthFrame.h"
+#include "DepthProcessor.h"
+#include "TripleBuffer.h"
+
+class DepthPipeline : public ofThread {
+  public:
+    void start();
+    void stop();
+
+    // Any thread
+    void setSettings(const DepthSettings &settings);
+    void push(DepthFrame &frame); // Swaps the frame in, the caller gets an old buffer back to fill.
+
+    // Reader (main thread)
+    bool update(); // Picks up the latest frame, true if it's new.
+    const PeopleFrame &getFrame() const { return frames.getReadBuffer(); }
+
+  private:
+    void threadedFunction() override;
+
+    DepthProcessor processor;
+    TripleBuffer<PeopleFrame> frames;
+
+    std::mutex mutex;
+    std::condition_variable hasInput;
+    DepthFrame pending;
+    bool isPending = false;
+    DepthSettings settings;
+};
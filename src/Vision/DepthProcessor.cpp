@@ -0,0 +1,164 @@
+#include "DepthProcessor.h"
+
+void DepthProcessor::process(const DepthFrame &input, const DepthSettings &settings, PeopleFrame &output) {
+  auto start = std::chrono::steady_clock::now();
+
+  // What's in front of the background, last frame's people don't become part of it.
+  if (!settings.background) {
+    background.reset();
+  }
+  auto &raw = settings.background ? background.apply(input.depth, mask, settings) : input.depth;
+
+  // 8 bit depth of the range we care about, and the mask of who's in it.
+  output.regions.clear();
+  output.isFullScan = isFullScanDue(raw, settings);
+  if (!output.isFullScan) {
+    findRegions(raw, settings);
+    size_t area = 0; size_t work = 0;
+    for (int i = 0; i < regions.size(); i++) {
+      area += regions[i].area();
+      work += crops[i].area();
+    }
+    output.coverage = (float) area / raw.size();
+    output.isFullScan = work > raw.size() / 2; // Cheaper in one go.
+  }
+
+  if (output.isFullScan) {
+    depthMask.process(raw, settings, output.depth, mask);
+    output.coverage = 1;
+    lastFullScan = frameIdx;
+  } else {
+    if (output.depth.getWidth() != raw.getWidth() || output.depth.getHeight() != raw.getHeight()) {
+      output.depth.allocate(raw.getWidth(), raw.getHeight(), OF_PIXELS_GRAY);
+    }
+    depthMask.mapDepth(raw.getData(), raw.size(), settings, output.depth.getData());
+    refineRegions(raw, settings);
+    for (auto &r : regions) {
+      output.regions.push_back(ofxCv::toOf(r));
+    }
+  }
+
+  // Set contour finder's properties.
+  contourFinder.setMinAreaRadius(settings.minArea);
+  contourFinder.setMaxAreaRadius(settings.maxArea);
+  contourFinder.setThreshold(settings.contourThreshold);
+  auto maskMat = ofxCv::toCv(mask);
+  contourFinder.findContours(maskMat);
+
+  // People
+  output.blobs.resize(contourFinder.size());
+  for (int i = 0; i < contourFinder.size(); i++) {
+    auto &blob = output.blobs[i];
+    blob.centroid = ofxCv::toOf(contourFinder.getCenter(i));
+    blob.contour = contourFinder.getPolyline(i);
+    blob.label = contourFinder.getLabel(i);
+    blob.age = contourFinder.getTracker().getAge(blob.label);
+  }
+
+  output.timestamp = input.timestamp;
+  output.frameIdx = frameIdx++;
+
+  // Where they're heading.
+  tracker.update(output, settings.velocitySmoothing);
+
+  output.processingTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool DepthProcessor::isFullScanDue(const ofShortPixels &raw, const DepthSettings &settings) {
+  int scale = 1 << std::max(settings.pyramidLevel, 0);
+  return settings.pyramidLevel <= 0
+    || raw.getWidth() < scale || raw.getHeight() < scale
+    || mask.getWidth() != raw.getWidth() || mask.getHeight() != raw.getHeight() // Nothing tracked yet.
+    || (settings.rescanInterval > 0 && frameIdx - lastFullScan >= settings.rescanInterval);
+}
+
+void DepthProcessor::findRegions(const ofShortPixels &raw, const DepthSettings &settings) {
+  int w = raw.getWidth(); int h = raw.getHeight();
+  int scale = 1 << settings.pyramidLevel;
+  cv::Rect image(0, 0, w, h);
+  regions.clear();
+
+  // Mask of the pyramid level, from every scale'th pixel. Blur and morphology shrink with
+  // it, erosion rounded down and dilation up, so the regions only err on the big side.
+  int cw = w / scale; int ch = h / scale;
+  coarseRaw.resize(cw * ch); coarseDepth.resize(cw * ch); coarsePixels.resize(cw * ch);
+  auto src = raw.getData();
+  for (int y = 0; y < ch; y++) {
+    auto row = src + y * scale * w;
+    for (int x = 0; x < cw; x++) {
+      coarseRaw[y * cw + x] = row[x * scale];
+    }
+  }
+  auto coarseSettings = settings;
+  coarseSettings.blur = settings.blur / scale;
+  coarseSettings.erosion = ((2 * settings.erosion + 1) / scale - 1) / 2;
+  coarseSettings.dilation = (settings.dilation + scale - 1) / scale;
+  coarseMask.process(coarseRaw.data(), cw, ch, coarseSettings, coarseDepth.data(), coarsePixels.data());
+
+  // Everybody in it, a pyramid pixel wider on each side for the sampling.
+  cv::Mat coarse(ch, cw, CV_8UC1, coarsePixels.data());
+  cv::findContours(coarse, coarseContours, CV_RETR_EXTERNAL, CV_CHAIN_APPROX_SIMPLE);
+  for (auto &contour : coarseContours) {
+    auto r = cv::boundingRect(contour);
+    regions.push_back(cv::Rect((r.x - 1) * scale, (r.y - 1) * scale, (r.width + 2) * scale, (r.height + 2) * scale));
+  }
+
+  // And whoever we tracked last frame, where they were and where they're heading.
+  for (int i = 0; i < contourFinder.size(); i++) {
+    auto r = contourFinder.getBoundingRect(i);
+    auto v = contourFinder.getVelocity(i);
+    regions.push_back(r | (r + cv::Point(v[0], v[1])));
+  }
+
+  // Pad, clip and merge the ones that overlap, so every pixel is refined once.
+  int pad = settings.regionPadding;
+  for (auto &r : regions) {
+    r = cv::Rect(r.x - pad, r.y - pad, r.width + 2 * pad, r.height + 2 * pad) & image;
+  }
+  ofRemove(regions, [](const cv::Rect &r) { return r.area() == 0; });
+  for (int i = 0; i < regions.size(); i++) {
+    for (int j = i + 1; j < regions.size(); j++) {
+      if ((regions[i] & regions[j]).area() > 0) {
+        regions[i] |= regions[j];
+        regions.erase(regions.begin() + j);
+        j = i; // It grew, check them all again.
+      }
+    }
+  }
+
+  // With enough depth around every region that its mask comes out as the full frame's.
+  int reach = DepthMask::getReach(settings);
+  crops.clear();
+  for (auto &r : regions) {
+    crops.push_back(cv::Rect(r.x - reach, r.y - reach, r.width + 2 * reach, r.height + 2 * reach) & image);
+  }
+}
+
+void DepthProcessor::refineRegions(const ofShortPixels &raw, const DepthSettings &settings) {
+  int w = raw.getWidth();
+  memset(mask.getData(), 0, mask.size());
+
+  auto src = raw.getData(); auto dst = mask.getData();
+  for (int i = 0; i < regions.size(); i++) {
+    auto &r = regions[i]; auto &crop = crops[i];
+    regionRaw.resize(crop.area()); regionDepth.resize(crop.area()); regionMask.resize(crop.area());
+    for (int y = 0; y < crop.height; y++) {
+      memcpy(&regionRaw[y * crop.width], src + (crop.y + y) * w + crop.x, crop.width * sizeof(unsigned short));
+    }
+    depthMask.process(regionRaw.data(), crop.width, crop.height, settings, regionDepth.data(), regionMask.data());
+    for (int y = r.y; y < r.y + r.height; y++) {
+      memcpy(dst + y * w + r.x, &regionMask[(y - crop.y) * crop.width + r.x - crop.x], r.width);
+    }
+  }
+}
+
+void DepthProcessor::mapDepth(const ofShortPixels &depth, float minDistance, float maxDistance, ofPixels &output) {
+  if (output.getWidth() != depth.getWidth() || output.getHeight() != depth.getHeight()) {
+    output.allocate(depth.getWidth(), depth.getHeight(), OF_PIXELS_GRAY);
+  }
+  auto src = depth.getData();
+  auto dst = output.getData();
+  for (size_t i = 0; i < depth.size(); i++) {
+    dst[i] = ofMap(src[i], minDistance, maxDistance, 255, 0, true);
+  }
+}
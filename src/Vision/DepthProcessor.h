@@ -0,0 +1,50 @@
+// Finds people in a raw depth frame: drops the learned background if there is one (see
+// DepthBackground), maps the range we care about to 8 bits, cleans it up (blur, erode,
+// dilate, threshold, see DepthMask) and finds the contours. It runs on
+// whatever thread calls it and keeps its buffers around, so it doesn't allocate once
+// it's warmed up.
+//
+// People only cover a few blobs of the frame, so with a pyramid level set the mask is
+// found on the downsampled frame first. The full resolution mask is then only made in
+// padded regions around what it found and around the people tracked last frame (moved
+// by their velocity), and is empty everywhere else. Every rescanInterval frames, or when
+// the regions cover most of the frame anyway, it's the whole frame again.
+#pragma once
+#include "ofMain.h"
+#include "ofxCv.h"
+#include "DepthFrame.h"
+#include "AudienceTracker.h"
+#include "DepthMask.h"
+#include "DepthBackground.h"
+
+class DepthProcessor {
+  public:
+    void process(const DepthFrame &input, const DepthSettings &settings, PeopleFrame &output);
+
+    // The range mapping ofxKinectV2 does for its depth pixels.
+    static void mapDepth(const ofShortPixels &depth, float minDistance, float maxDistance, ofPixels &output);
+
+  private:
+    bool isFullScanDue(const ofShortPixels &raw, const DepthSettings &settings);
+    void findRegions(const ofShortPixels &raw, const DepthSettings &settings);
+    void refineRegions(const ofShortPixels &raw, const DepthSettings &settings);
+
+    DepthBackground background;
+    DepthMask depthMask;
+    ofPixels mask; // Who is in range, 0 or 255.
+    ofxCv::ContourFinder contourFinder;
+    AudienceTracker tracker;
+    uint64_t frameIdx = 0;
+    uint64_t lastFullScan = 0;
+
+    // Pyramid level.
+    DepthMask coarseMask;
+    std::vector<unsigned short> coarseRaw;
+    std::vector<unsigned char> coarseDepth, coarsePixels;
+    std::vector<std::vector<cv::Point>> coarseContours;
+
+    // Full resolution regions.
+    std::vector<cv::Rect> regions, crops; // Crop: the depth a region's mask needs.
+    std::vector<unsigned short> regionRaw;
+    std::vector<unsigned char> regionDepth, regionMask;
+};
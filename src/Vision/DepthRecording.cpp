@@ -0,0 +1,228 @@
+#include "DepthRecording.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+static const char recordingMagic[4] = { 'N', 'D', 'P', 'T' };
+static const uint32_t recordingVersion = 1;
+
+// ------------------------------ DepthRecorder --------------------------------------- //
+
+DepthRecorder::~DepthRecorder() {
+  stop();
+}
+
+bool DepthRecorder::start(std::string p) {
+  stop();
+  path = p;
+  file = fopen(ofToDataPath(path, true).c_str(), "wb");
+  if (file == NULL) {
+    ofLogError("DepthRecorder") << "Can't write " << path;
+    return false;
+  }
+  memcpy(header.magic, recordingMagic, 4);
+  header.version = recordingVersion;
+  header.width = 0; header.height = 0; header.numFrames = 0;
+  // Final header in stop().
+  if (fwrite(&header, sizeof(header), 1, file) != 1) {
+    ofLogError("DepthRecorder") << "Can't write " << path;
+    fclose(file);
+    file = NULL;
+    return false;
+  }
+  numQueued = 0; numDropped = 0; numWritten = 0;
+  isFailed = false;
+  startThread();
+  ofLog() << "Recording depth to " << path << endl;
+  return true;
+}
+
+void DepthRecorder::write(const DepthFrame &frame) {
+  if (file == NULL) {
+    return;
+  }
+  if (isFailed) {
+    stop();
+    return;
+  }
+  // The first frame sets the size.
+  if (numQueued == 0) {
+    header.width = frame.depth.getWidth();
+    header.height = frame.depth.getHeight();
+  } else if (frame.depth.getWidth() != header.width || frame.depth.getHeight() != header.height) {
+    ofLogWarning("DepthRecorder") << "Skipping a frame of a different size.";
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (queue.size() >= maxQueued) {
+      numDropped++; // The disk can't keep up.
+      return;
+    }
+    DepthFrame copy;
+    if (!spare.empty()) {
+      std::swap(copy, spare.back());
+      spare.pop_back();
+    }
+    copy.depth = frame.depth; // Reuses the buffer's pixels.
+    copy.timestamp = frame.timestamp;
+    queue.push_back(std::move(copy));
+    numQueued++;
+  }
+  hasFrames.notify_one();
+}
+
+void DepthRecorder::stop() {
+  if (file == NULL) {
+    return;
+  }
+  if (isThreadRunning()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex); // So the thread can't miss the wake up.
+      stopThread();
+    }
+    hasFrames.notify_all();
+    waitForThread(false); // Writes what's still queued first.
+  }
+  queue.clear();
+
+  header.numFrames = numWritten;
+  // Even after a failed write, so the frames before it can be replayed.
+  bool isWritten = fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+  isWritten &= fclose(file) == 0;
+  file = NULL;
+  if (isFailed || !isWritten) {
+    ofLogError("DepthRecorder") << "Recording to " << path << " failed after " << header.numFrames
+                                << " frames, is the disk full?";
+  } else {
+    ofLog() << "Recorded " << header.numFrames << " depth frames." << endl;
+  }
+  if (numDropped > 0) {
+    ofLogWarning("DepthRecorder") << "Dropped " << numDropped << " depth frames, the disk couldn't keep up.";
+  }
+}
+
+void DepthRecorder::threadedFunction() {
+  DepthFrame frame;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      if (frame.depth.isAllocated()) {
+        spare.push_back(std::move(frame));
+        frame = DepthFrame();
+      }
+      hasFrames.wait(lock, [&] { return !queue.empty() || !isThreadRunning(); });
+      if (queue.empty()) {
+        break; // Stopped and everything is written.
+      }
+      std::swap(frame, queue.front());
+      queue.pop_front();
+    }
+
+    // After a failed write the rest is dropped, stop() tells.
+    if (!isFailed) {
+      if (writeFrame(frame)) {
+        numWritten++;
+      } else {
+        ofLogError("DepthRecorder") << "Can't write a depth frame to " << path << ", is the disk full?";
+        isFailed = true;
+      }
+    }
+  }
+}
+
+bool DepthRecorder::writeFrame(const DepthFrame &frame) {
+  return fwrite(&frame.timestamp, sizeof(frame.timestamp), 1, file) == 1 &&
+         fwrite(frame.depth.getData(), sizeof(unsigned short), frame.depth.size(), file) == frame.depth.size();
+}
+
+// ------------------------------ DepthReplay --------------------------------------- //
+
+DepthReplay::~DepthReplay() {
+  close();
+}
+
+bool DepthReplay::load(std::string path) {
+  close();
+  auto fullPath = ofToDataPath(path, true);
+  int fd = open(fullPath.c_str(), O_RDONLY);
+  if (fd < 0) {
+    ofLogError("DepthReplay") << "Can't open " << path;
+    return false;
+  }
+  struct stat st;
+  fstat(fd, &st);
+  size = st.st_size;
+  if (size < sizeof(header)) {
+    ofLogError("DepthReplay") << path << " isn't a depth recording.";
+    ::close(fd);
+    return false;
+  }
+
+  // Private and writable, so frames can be handed out as ofPixels. Nothing ever writes to them.
+  void *mapped = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (mapped == MAP_FAILED) {
+    ofLogError("DepthReplay") << "Can't map " << path;
+    return false;
+  }
+  data = (unsigned char *) mapped;
+  memcpy(&header, data, sizeof(header));
+
+  frameSize = sizeof(uint64_t) + header.width * header.height * sizeof(unsigned short);
+  if (memcmp(header.magic, recordingMagic, 4) != 0 || header.version != recordingVersion || header.numFrames == 0 ||
+      sizeof(header) + header.numFrames * frameSize > size) {
+    ofLogError("DepthReplay") << path << " isn't a depth recording.";
+    close();
+    return false;
+  }
+
+  ofLog() << "Replaying " << header.numFrames << " depth frames (" << header.width << "x" << header.height << ") from " << path << endl;
+  return true;
+}
+
+void DepthReplay::close() {
+  if (data != NULL) {
+    munmap(data, size);
+    data = NULL;
+    size = 0;
+  }
+}
+
+uint64_t DepthReplay::getDuration() {
+  return header.numFrames > 0 ? getTimestamp(header.numFrames - 1) - getTimestamp(0) : 0;
+}
+
+void DepthReplay::getFrame(int idx, DepthFrame &frame) {
+  auto record = getRecord(idx);
+  memcpy(&frame.timestamp, record, sizeof(uint64_t));
+  auto pixels = (unsigned short *) (record + sizeof(uint64_t));
+  frame.depth.setFromExternalPixels(pixels, header.width, header.height, OF_PIXELS_GRAY);
+}
+
+int DepthReplay::getFrameIdx(uint64_t elapsed) {
+  // Timestamps only go up, binary search them.
+  auto start = getTimestamp(0);
+  int lo = 0; int hi = header.numFrames - 1;
+  while (lo < hi) {
+    int mid = (lo + hi + 1) / 2;
+    if (getTimestamp(mid) - start <= elapsed) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  return lo;
+}
+
+uint64_t DepthReplay::getTimestamp(int idx) {
+  uint64_t timestamp;
+  memcpy(&timestamp, getRecord(idx), sizeof(uint64_t));
+  return timestamp;
+}
+
+unsigned char *DepthReplay::getRecord(int idx) {
+  return data + sizeof(header) + idx * frameSize;
+}
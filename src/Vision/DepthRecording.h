@@ -0,0 +1,71 @@
+// Raw depth frames on disk, so the pipeline can be tuned and benchmarked without a
+// Kinect. A recording is a header and then fixed size frames (timestamp + 16 bit depth
+// in mm), so any frame can be found without reading the ones before it.
+#pragma once
+#include "ofMain.h"
+#include "DepthFrame.h"
+
+struct DepthRecordingHeader {
+  char magic[4]; // NDPT
+  uint32_t version;
+  uint32_t width;
+  uint32_t height;
+  uint64_t numFrames;
+};
+
+// Frames are copied into a short queue and written by the recorder's own thread, so a
+// slow disk never holds up the main thread. Frames are dropped when the queue is full.
+class DepthRecorder : public ofThread {
+  public:
+    ~DepthRecorder();
+    bool start(std::string path); // Relative to the data folder.
+    void write(const DepthFrame &frame); // Main thread. Stops recording if a write failed.
+    void stop(); // Writes what's queued and the frame count in the header.
+    bool isRecording() { return file != NULL; }
+    uint64_t getNumFrames() { return numWritten; }
+
+  private:
+    void threadedFunction() override;
+    bool writeFrame(const DepthFrame &frame);
+
+    FILE *file = NULL;
+    DepthRecordingHeader header;
+    std::string path;
+
+    std::mutex mutex;
+    std::condition_variable hasFrames;
+    std::deque<DepthFrame> queue; // For the writer thread.
+    std::vector<DepthFrame> spare; // Written, buffers to reuse.
+    static const int maxQueued = 8; // ~3.5 MB at 512x424.
+    uint64_t numQueued = 0;
+    uint64_t numDropped = 0;
+    std::atomic<uint64_t> numWritten { 0 };
+    std::atomic<bool> isFailed { false };
+};
+
+// Maps a recording into memory. Frames point straight into the mapping, nothing is copied.
+class DepthReplay {
+  public:
+    ~DepthReplay();
+    bool load(std::string path); // Relative to the data folder.
+    void close();
+    bool isLoaded() { return data != NULL; }
+
+    int getNumFrames() { return header.numFrames; }
+    int getWidth() { return header.width; }
+    int getHeight() { return header.height; }
+    uint64_t getDuration(); // us, first to last frame.
+
+    // Points the frame at a recorded one. The pixels stay valid until close().
+    void getFrame(int idx, DepthFrame &frame);
+    int getFrameIdx(uint64_t elapsed); // Last frame recorded at or before this time since the first one (us).
+
+  private:
+    uint64_t getTimestamp(int idx);
+    unsigned char *getRecord(int idx);
+
+    DepthRecordingHeader header;
+    unsigned char *data = NULL; // The whole file.
+    size_t size = 0;
+    size_t frameSize = 0; // Timestamp + pixels.
+};
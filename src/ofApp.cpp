@@ -8,14 +8,11 @@ void ofApp::setup(){
   ofEnableSmoothing();
   ofEnableAlphaBlending();
   
-  box2d.init();
-  box2d.setGravity(0, 0.0);
-  box2d.setFPS(60);
-  box2d.enableEvents();
-  box2d.registerGrabbing(); // Enable grabbing the circles.
-  
-  ofAddListener(box2d.contactStartEvents, this, &ofApp::contactStart);
-  ofAddListener(box2d.contactEndEvents, this, &ofApp::contactEnd);
+  // Simulation core.
+  nest.setup(ofGetWidth(), ofGetHeight());
+  nestThread.setup(&nest);
+  ofAddListener(nestThread.agentCreatedEvent, this, &ofApp::onAgentCreated);
+  ofAddListener(nestThread.agentExplodedEvent, this, &ofApp::onAgentExploded);
   
   // Setup FBOs for drawing and masking the works.
   masterFbo.allocate(ofGetWidth(), ofGetHeight(), GL_RGBA);
@@ -33,20 +30,15 @@ void ofApp::setup(){
   
   // Setup gui.
   setupGui();
+  nestThread.setThreaded(simulationThread);
   
-  isOccupied = false;
   showGui = false;
   debug = false;
   showTexture = true;
   drawFbo = false;
-  shouldBond = false;
   hideKinectGui = false;
   showFrameRate = false;
   showMask = true;
-  
-  // Pending deleted agents.
-  pendingAgentsNum = 0;
-  pendingAgentTime = 0;
 
   engine.listDevices();
   
@@ -55,9 +47,6 @@ void ofApp::setup(){
   
   glEnable(GL_POINT_SMOOTH);
   
-  // Init the joint mesh to start with.
-  SuperAgent::initJointMesh();
-  
   // Variable to keep track of who enters/exits the sapce
   prevPeopleSize = 0;
   
@@ -80,130 +69,23 @@ void ofApp::setup(){
   // Setup in the call. 
   
   // Create the world
-  createWorld(true);
-  
-  resetMesh = false;
-  agentIdx = 0;
+  createWorld(false);
 }
 
 void ofApp::update(){
-  box2d.update();
   kinect.update();
   
-  // Update super agents
-  ofRemove(superAgents, [&](SuperAgent &sa){
-    sa.update(box2d, brokenBonds, resetMesh, shouldBond); // Possibly update the mesh here as well (for the interAgentJoints)
-    return sa.shouldRemove;
-  });
-
-  if (resetMesh) {
-	  // If I have removed something, update the mesh.
-	  SuperAgent::jointMesh.clear();
-	  SuperAgent::curMeshIdx = 0;
-	  for (auto &sa : superAgents) {
-		  sa.updateMeshIdx();
-	  }
-	  resetMesh = false; 
-  }
-  
-  // Update agents and remove them if their stretch
-  // counter goes crazy.
-  box2d.disableEvents();
-  ofRemove(agents, [&](Agent *a) {
-    a->update(alphaAgentProps, betaAgentProps);
-    if (a->canExplode()) { // Do everything when agent will explode!
-	
-      // Fill exploded agents
-      for (int i = 0; i < a->vertices.size()/4; i++) {
-        Memory m (box2d, a->getCentroid(), true);
-        explodedAgent.push_back(m);
-      }
-      
-      // Go through colliding bodies and see if this agent's body is one
-      // of the colliding bodies => If it is, clear that colliding body
-      bool found = false;
-      for (auto b : collidingBodies) {
-         auto agent = reinterpret_cast<VertexData*>(b->GetUserData())->agent;
-         if (agent == a) {
-          found = true;
-          break;
-         }
-      }
-      if (found) {
-        collidingBodies.clear();
-      }
-      ofRemove(collidingBodies, [&](b2Body *b) {
-         auto agentA = reinterpret_cast<VertexData*>(b->GetUserData())->agent;
-         return agentA == a;
-      });
-
-
-      // Stop playing the stretch sound for the agent
-      a->agentStretchSound(false);
-      
-      // Play the pop sound for the agent.
-       popPlayer.play();
-      
-      if (pendingAgentsNum == 0) {
-          pendingAgentTime = ofGetElapsedTimeMillis(); // Reset time if it's the first time a new agent is deleted.
-      }
-
-      pendingAgentsNum++;
-	    a->clean(box2d); // Clean all the vertices and joints.
-   
-      return true;
-    }
-    return false;
-  });
-  box2d.enableEvents();
-  
-  // NOTE: New creates are born right here. 
-  if (ofGetElapsedTimeMillis() - pendingAgentTime > reincarnationWaitTime && pendingAgentsNum > 0) { // 30 seconds.
-    ofLog() << "Time elaped: Creating Agents: " << pendingAgentsNum << endl;
-    if (pendingAgentsNum >= maxAgentsInWorld) {
-      pendingAgentsNum = maxAgentsInWorld;
-    }
-    createAgents(pendingAgentsNum);
-    pendingAgentsNum = 0;
-  }
-  
   // GUI props.
   updateAgentProps();
   
-  // All the interaction logic.
+  // All the interaction logic (steps the nest).
   handleInteraction();
   
-  // Update agents.
-  for (auto &a : agents) {
-    a->update(alphaAgentProps, betaAgentProps);
-  }
-
-  // Create super agents based on collision bodies.
-  createSuperAgents();
-  
   // Update background
   if (bg.isAllocated()) {
       bg.updateBackground(); 
   }
 
-  // Update broken bonds.
-  ofRemove(brokenBonds, [&](Memory &m) {
-    m.update();
-    if (m.shouldRemove) {
-      m.destroy();
-    }
-    return m.shouldRemove;
-  });
-  
-  // Update explodedAgents
-  ofRemove(explodedAgent, [&](Memory &m) {
-    m.update();
-    if (m.shouldRemove) {
-      m.destroy();
-    }
-    return m.shouldRemove;
-  });
-  
   // Screen Grab logic
   //  if (drawFbo) {
   //    screenGrabFbo.begin();
@@ -212,10 +94,13 @@ void ofApp::update(){
   //    screenGrabFbo.end();
   //  }
   
+  renderProfiler.beginFrame();
+  renderProfiler.begin(NestPhase::Render);
   masterFbo.begin();
     ofClear(0, 0, 0, 0);
-    drawSequence();
+    drawSequence(nestThread.getSnapshot());
   masterFbo.end();
+  renderProfiler.end(NestPhase::Render);
   
   // Only mask when in debug mode.
   if (debug || !showMask) {
@@ -244,6 +129,15 @@ void ofApp::draw(){
     ofPopMatrix();
   }
   
+  if (kinect.isCalibrating) {
+    kinect.drawCalibration();
+  }
+  
+  // Where the frame time goes.
+  if (debug) {
+    ofDrawBitmapStringHighlight(getFrameStats(nestThread.getSnapshot()), ofGetWidth() - 250, 50);
+  }
+  
   if (debug) {
     ofShowCursor();
   } else {
@@ -257,29 +151,40 @@ void ofApp::draw(){
   }
 }
 
-void ofApp::drawSequence() {
-  // Draw background.
-  if (bg.isAllocated()) {
-    bg.draw(debug);
+std::string ofApp::getFrameStats(const NestSnapshot &snapshot) {
+  // How steady the frames are.
+  float mean = 0, variance = 0;
+  for (auto t : frameTimes) {
+    mean += t;
   }
-  
-  // Draw all the interAgent joints. 
-  SuperAgent::drawJointMesh();
-  
-  // Draw Agent is the virtual method for derived class.
-  for (auto a: agents) {
-    a->draw(showVisibilityRadius, showTexture);
+  mean /= std::max((int) frameTimes.size(), 1);
+  for (auto t : frameTimes) {
+    variance += (t - mean) * (t - mean);
+  }
+  variance /= std::max((int) frameTimes.size(), 1);
+
+  std::stringstream ss;
+  ss << "Simulation (" << (nestThread.isThreaded() ? "thread" : "inline") << ")" << endl;
+  ss << snapshot.profile;
+  ss << "Draw: " << ofToString(renderProfiler.getAverage(NestPhase::Render), 3) << " ms" << endl;
+  ss << "Frame: " << ofToString(mean, 2) << " ms, Jitter: " << ofToString(sqrt(variance), 2) << " ms" << endl;
+  if (kinect.kinectOpen) {
+    auto &audience = kinect.getAudience();
+    ss << "Audience: " << audience.points.size() << ", Age: " << ofToString(audience.getAge(), 1)
+       << " ms (processing " << ofToString(audience.processingTime, 1) << " ms)" << endl;
   }
+  ss << "Nests: " << snapshot.numNests << ", Largest: " << snapshot.largestNest;
+  return ss.str();
+}
 
-  // Draw broken bonds
-  for (auto m : brokenBonds) {
-    m.draw();
+void ofApp::drawSequence(const NestSnapshot &snapshot) {
+  // Draw background.
+  if (bg.isAllocated()) {
+    bg.draw(debug);
   }
   
-  // Draw exploded agents
-  for (auto m : explodedAgent) {
-    m.draw();
-  }
+  // Joints, agents and memories.
+  renderer.draw(snapshot, showVisibilityRadius, showTexture);
   
   // All debug logic.
   if (debug) {
@@ -297,12 +202,26 @@ void ofApp::drawSequence() {
   // TODO: Comes from the GUI. 
   if (showVisibilityRadius) {
     // Draw the visibility radius around agents as well as users
-    auto people = kinect.getBodyCentroids();
+    auto &audience = kinect.getAudience();
     ofPushStyle();
       ofNoFill();
-      for (auto p : people) {
+      if (audience.occupancy.isSetup()) {
+        // Silhouettes decide who's touched.
+        ofSetColor(ofColor::red, 100);
+        auto &grid = audience.occupancy;
+        auto size = grid.getCellSize();
+        for (int row = 0; row < grid.getNumRows(); row++) {
+          for (int col = 0; col < grid.getNumCols(); col++) {
+            if (grid.isCellOccupied(col, row)) {
+              ofDrawRectangle(col * size, row * size, size, size);
+            }
+          }
+        }
+      } else {
         ofSetColor(ofColor::red);
-        ofDrawCircle(p, audienceVisibilityRadius);
+        for (auto &p : audience.points) {
+          ofDrawCircle(p, audienceVisibilityRadius);
+        }
       }
     ofPopStyle();
   }
@@ -329,6 +248,15 @@ void ofApp::drawSequence() {
 
 // ------------------ Activate Agent Behaviors With Audience Interaction --------------------- //
 void ofApp::mousePressed(int x, int y, int button) {
+  if (kinect.isCalibrating) {
+    if (button == 0) {
+      kinect.addCalibrationPoint(glm::vec2(x, y));
+    } else if (button == 2) {
+      kinect.removeCalibrationPoint();
+    }
+    return;
+  }
+  
   if (button == 2) { // Right click.
     if (testPeople.size() > 0) {
         // Trim the array
@@ -340,176 +268,39 @@ void ofApp::mousePressed(int x, int y, int button) {
     } else if (button == 0) { // Left click.
       testPeople.push_back(glm::vec2(x, y));
     }
-}
-
-void ofApp::handleInteraction() {
-  if (kinect.kinectOpen) {
-    // Is the area occupied?
-    auto people = kinect.getBodyCentroids();
-    isOccupied = people.size() > 0;
-    
-    if (isOccupied) {
-      // Agents can bond now.
-      shouldBond = true;
-      setBehavior(people);
-      specialRepelTimer = ofRandom(200, 300);
-    } else {
-      for (auto &a : agents) {
-        a->agentStretchSound(false); // It can happen here that targets disappear.
-      }
-      if (specialRepelTimer > 0) {
-        enableRepelBeforeBreak();
-      } else {
-        wasteTime();
-        clearInterAgentBonds();
-      }
-    }
-  } else { // Test Routine
-    isOccupied = testPeople.size() > 0;
-    
-    if (isOccupied) {
-      shouldBond = true;
-      setBehavior(testPeople);
-      specialRepelTimer = ofRandom(200, 300);
-    } else {
-      for (auto &a : agents) {
-        a->agentStretchSound(false); // It can happen here that targets disappear.
-      }
-      if (specialRepelTimer > 0) {
-        enableRepelBeforeBreak();
-      } else {
-        // Do other silly things
-        wasteTime();
-        clearInterAgentBonds();
-      }
-    }
-  }
-}
-
-void ofApp::evaluateEntryExit(int curPeopleSize) {  
-    prevPeopleSize = curPeopleSize; 
-}
-
-void ofApp::setBehavior(std::vector<glm::vec2> people) {
-  // Get all visible agents.
-  for (auto p : people) {
-    // Visible Agents.
-    auto visibleAgents = getVisibleAgents(p);
-    // Apply stretch on visible agents
-    for (auto &a : visibleAgents) {
-      a->setBehavior(Behavior::Stretch, {}, true); // All visible agents, turn on the note! They turn it off, as soon as they become invisible
-      a->agentStretchSound(true);
-    }
-  }
-  
-  // Toss a coin on the invisible targets for each agent
-  // to attract or repel from the people.
-  for (auto &a : agents) {
-    auto invisibleTargets = getInvisibleTargets(people, a);
-    if (ofRandom(1) < 0.85) {
-      a->setBehavior(Behavior::Attract, invisibleTargets);
-    } else {
-      a->setBehavior(Behavior::Repel, invisibleTargets);
-    }
-    
-    // How do I test if an agent is in the nest or nest or not. 
-    
-    // If no visible targets, turn off the midi.
-    auto numVisibleTargets = people.size() - invisibleTargets.size();
-    if (numVisibleTargets == 0) {
-      a->agentStretchSound(false);
-      a->stretchCounter = 0; 
-    }
-  }
-}
-
-void ofApp::wasteTime() {
-  for (auto &a : agents) {
-    auto target = glm::vec2(ofRandom(50, ofGetWidth()-50), ofRandom(50, ofGetHeight()-50));
-    if (ofRandom(1) < 0.3) { // Low priority for seeking targets. Lower the movement.
-      a->setBehavior(Behavior::Attract, { target });
-    } else {
-      a->setBehavior(Behavior::Shock); 
-    }
-  }
-}
 
-void ofApp::enableRepelBeforeBreak() {
-  if (superAgents.size() > 0) {
-    // Keep tracking time.
-    if (specialRepelTimer > 0) {
-      specialRepelTimer--;
-    }
-    
-    // Enable special repel. 
-    for (auto &sa : superAgents) {
-      auto agentA = sa.agentA;
-      auto agentB = sa.agentB;
-      agentA->setBehavior(Behavior::SpecialRepel, { agentB->getCentroid() });
-      agentB->setBehavior(Behavior::SpecialRepel, { agentA->getCentroid() });
-    }
-  }
+  // Grab the circles. The world belongs to the simulation thread.
+  nestThread.post([x, y](Nest &n) { n.box2d.grabShapeDown(x, y); });
 }
 
-void ofApp::clearInterAgentBonds() {
-  shouldBond = false;
-  if (superAgents.size() == 0) {
-    SuperAgent::initJointMesh(); // Clear the mesh and reinitialize
-  }
+void ofApp::mouseDragged(int x, int y, int button) {
+  nestThread.post([x, y](Nest &n) { n.box2d.grabShapeDragged(x, y); });
 }
 
-Agent* ofApp::getClosestAgent(std::vector<Agent *> targetAgents, glm::vec2 targetPos) {
-  auto minD = 9999;
-  Agent *minAgent = NULL;
-  for (auto &a : targetAgents) {
-    auto d = glm::distance(targetPos, a->getCentroid());
-    if (d < minD) {
-      minD = d;
-      minAgent = a;
-    }
-  }
-  return minAgent;
+void ofApp::mouseReleased(int x, int y, int button) {
+  nestThread.post([x, y](Nest &n) { n.box2d.grabShapeUp(x, y); });
 }
 
-std::vector<glm::vec2> ofApp::getInvisibleTargets(std::vector<glm::vec2> people, Agent* a) {
-  std::vector<glm::vec2> invisibleTargets;
-  for (auto p : people) {
-    auto d = glm::distance(a->getCentroid(), p);
-    if (d > audienceVisibilityRadius + a->visibilityRadius) {
-      invisibleTargets.push_back(p);
-    }
+void ofApp::handleInteraction() {
+  // Frame times for the jitter.
+  frameTimes.push_back(ofGetLastFrameTime() * 1000);
+  if (frameTimes.size() > 120) {
+    frameTimes.pop_front();
   }
-  
-  return invisibleTargets;
-}
 
-std::vector<Agent *> ofApp::getVisibleAgents(glm::vec2 target) {
-  std::vector<Agent *> visibleAgents;
-  // Find the closest agents to the target
-  for (auto &a : agents) {
-    auto d = glm::distance(a->getCentroid(), target);
-    if (d <= a->visibilityRadius + audienceVisibilityRadius) {
-      visibleAgents.push_back(a);
-    }
+  if (kinect.kinectOpen) {
+    auto &audience = kinect.getAudience();
+    nestThread.setInput(audience.points, alphaAgentProps, betaAgentProps, nestProps, audience.occupancy);
+  } else { // Test Routine
+    nestThread.setInput(testPeople, alphaAgentProps, betaAgentProps, nestProps);
   }
-
-  return visibleAgents;
+  nestThread.update(ofGetLastFrameTime());
 }
 
-std::vector<Agent*> ofApp::getInvisibleAgents(glm::vec2 target) {
-  std::vector<Agent *> invisibleAgents;
-  // Find the closest agents to the target
-  for (auto &a : agents) {
-    auto d = glm::distance(a->getCentroid(), target);
-    if (d > a->visibilityRadius + audienceVisibilityRadius) {
-      invisibleAgents.push_back(a);
-    }
-  }
-
-  return invisibleAgents;
+void ofApp::evaluateEntryExit(int curPeopleSize) {  
+    prevPeopleSize = curPeopleSize; 
 }
 
-
 void ofApp::keyPressed(int key){
   // ------------------ Interactive Gestures --------------------- //
   if (key == 'f') {
@@ -560,6 +351,14 @@ void ofApp::keyPressed(int key){
     showMask = !showMask;
   }
   
+  if (key == 'r') {
+    kinect.toggleRecording();
+  }
+  
+  if (key == 'a') {
+    kinect.toggleCalibration();
+  }
+  
   // Save a screen grab of the high quality fbo that is getting drawn currently. 
   if (key == ' ') {
     ofPixels pix;
@@ -571,7 +370,9 @@ void ofApp::keyPressed(int key){
 }
 
 void ofApp::exit() {
-  box2d.disableEvents();
+  nestThread.exit();
+  nest.exit();
+  kinect.exit();
   gui.saveToFile("InterMesh.xml");
   kinect.gui.saveToFile("Kinect.xml");
 }
@@ -585,11 +386,7 @@ void ofApp::createWorld(bool createBounds) {
   }
   
   if (createBounds) {
-    ofLog() << "Creating new bounds." << endl;
-    // Bounds
-    bounds.x = -150; bounds.y = -150;
-    bounds.width = ofGetWidth() + (-1) * bounds.x * 2; bounds.height = ofGetHeight() + (-1) * 2 * bounds.y;
-    box2d.createBounds(bounds);
+    nestThread.post([](Nest &n) { n.createBounds(); });
     
     // Allocate the fbo for screen grabbing.
     if (screenGrabFbo.isAllocated()) {
@@ -615,6 +412,11 @@ void ofApp::setupGui() {
     generalParams.add(maxAgentsInWorld.set("Max Agents in World", 30, 0, 50));
     generalParams.add(reincarnationWaitTime.set("Reincarnate Agents Wait Time (ms)", 40000, 0, 60000));
     generalParams.add(maskImage.set("Mask Image Index (1-4)", 1, 1, 4));
+    generalParams.add(physicsHz.set("Physics Hz", 60, 30, 240));
+    generalParams.add(maxPhysicsSteps.set("Max Physics Steps Per Frame", 4, 1, 8));
+    generalParams.add(behaviorThreads.set("Behavior Threads (0 = all cores)", 0, 0, 16));
+    generalParams.add(simulationThread.set("Simulation Thread", true));
+    simulationThread.addListener(this, &ofApp::onSimulationThreadUpdate);
     maskImage.addListener(this, &ofApp::onMaskImgUpdate);
   
     // Alpha Agent GUI parameters
@@ -726,245 +528,56 @@ void ofApp::updateAgentProps() {
   betaAgentProps.tickleWeight = bTickleWeight;
   betaAgentProps.velocity = bVelocity;
   betaAgentProps.visibilityRadiusFactor = bVisibilityRadiusFactor;
-}
-
-glm::vec2 ofApp::getBodyPosition(b2Body* body) {
-  auto xf = body->GetTransform();
-  b2Vec2 pos = body->GetLocalCenter();
-  b2Vec2 b2Center = b2Mul(xf, pos);
-  auto p = worldPtToscreenPt(b2Center);
-  return glm::vec2(p.x, p.y);
+  
+  // World props.
+  nestProps.audienceVisibilityRadius = audienceVisibilityRadius;
+  nestProps.maxAgentsInWorld = maxAgentsInWorld;
+  nestProps.reincarnationWaitTime = reincarnationWaitTime;
+  nestProps.physicsHz = physicsHz;
+  nestProps.maxSubSteps = maxPhysicsSteps;
+  nestProps.behaviorThreads = behaviorThreads;
+  nestProps.jointPhysics = ofPoint(iJointFrequency, iJointDamping);
+  nestProps.jointLength = ofPoint(iMinJointLength, iMaxJointLength);
 }
 
 // ------------------------------ Interactive Routines --------------------------------------- //
 
 void ofApp::createAgents(int numAgents) {
-  
-  for (int i = 0; i < numAgents; i++) {
-    ofPoint origin = ofPoint(ofRandom(100, ofGetWidth()-100), ofRandom(100, ofGetHeight()-100));
-    Agent *agent;
-    alphaAgentProps.meshOrigin = origin;
-    // Create new agent.
-    agent = new Alpha(box2d, alphaAgentProps);
-   
-    // Instrument patching
-    osc_attack >> agent->instrument.in_attack();
-    osc_decay >> agent->instrument.in_decay();
-    osc_release >> agent->instrument.in_release();
-    osc_sustain >> agent->instrument.in_sustain();
-    osc_velocity >> agent->instrument.in_velocity();
-    
-    // Signal -> Filter -> Gain
-    agent->instrument.out_signal() >> filter.ch(i) >> gain.ch(i);
-    
-    // Feed it to the engine vi
-    gain.ch(i) >> compressor.ch(0) >> engine.audio_out(0);
-    gain.ch(i) >> compressor.ch(1) >> engine.audio_out(1);
-
-	  agent->id = agentIdx;
-    agents.push_back(agent);
-	  agentIdx++;
-  }
-  
-  ofLog() << "Total Agents: " << agents.size() << endl; 
+  nestThread.post([numAgents](Nest &n) { n.createAgents(numAgents); });
 }
 
-
 void ofApp::removeJoints() {
-  box2d.disableEvents();
-
-  // Clear superAgents only
-  for (auto &sa : superAgents) {
-    sa.clean(box2d);
-  }
-  superAgents.clear();
-  SuperAgent::initJointMesh(); // Clear the mesh and reinitialize
-
-  superAgents.clear();
-  box2d.enableEvents();
-}
-
-
-void ofApp::removeUnbonded() {
-  ofRemove(agents, [&](Agent *a) {
-    return false;
-  });
+  nestThread.post([](Nest &n) { n.removeJoints(); });
 }
 
 void ofApp::clearScreen() {
-  // [WARNING] For some reason, these events are still fired when trying to clean things as one could be in the
-  // middle of a step function. Disabling and renabling the events work as a good solution for now.
-  box2d.disableEvents();
-  collidingBodies.clear();
-
-  // Clear SuperAgents
-  for (auto &sa : superAgents) {
-    sa.clean(box2d);
-  }
-  superAgents.clear();
-  SuperAgent::initJointMesh(); // Clear the joint mesh as well.
-  
-  // Clean agents
-  for (auto &a : agents) {
-    a->clean(box2d);
-    delete a;
-  }
-  agents.clear();
-
-  box2d.enableEvents();
+  nestThread.post([](Nest &n) { n.clearScreen(); });
 }
 
-// ------------------------------ Agent Body Contact Routines --------------------------------------- //
+// ------------------------------ Nest Callbacks --------------------------------------- //
 
-void ofApp::contactStart(ofxBox2dContactArgs &e) {
+void ofApp::onAgentCreated(NestAgentEventArgs &args) {
+  auto agent = args.agent;
+  int i = args.idx;
   
-}
-
-// Joint creation sequence.
-void ofApp::contactEnd(ofxBox2dContactArgs &e) {
-  // Based on the current state of desire, what should the vertices do if they hit each other
-  // How do they effect each other?
-  if (agents.size() > 0) {
-    if(e.a != NULL && e.b != NULL) {
-      if(e.a->GetType() == b2Shape::e_circle && e.b->GetType() == b2Shape::e_circle
-          && e.a->GetBody() && e.b->GetBody()) {
-        // Extract Agent pointers.
-        Agent* agentA = reinterpret_cast<VertexData*>(e.a->GetBody()->GetUserData())->agent;
-        Agent* agentB = reinterpret_cast<VertexData*>(e.b->GetBody()->GetUserData())->agent;
-        
-        // DEFINE INDIVIDUAL VERTEX BEHAVIORS.
-        if (agentA != agentB && agentA != NULL && agentB != NULL) {
-          // Collect datas
-          auto dataA = reinterpret_cast<VertexData*>(e.a->GetBody()->GetUserData());
-          auto dataB = reinterpret_cast<VertexData*>(e.b->GetBody()->GetUserData());
-          
-          // Update positions for repelling.
-          auto pos = getBodyPosition(e.b->GetBody());
-          dataA->targetPos = pos;
-
-          pos = getBodyPosition(e.a->GetBody());
-          dataB->targetPos = pos;
-          
-          // Desire state is NONE! Repel the vertices from each
-          if (agentA->currentBehavior == None) {
-            if (ofRandom(1) < 0.90) {
-              dataA->applyRepulsion = true;
-              e.a->GetBody()->SetUserData(dataA);
-            } else {
-              dataA->applyAttraction = true;
-              e.a->GetBody()->SetUserData(dataA);
-            }
-          }
-          
-          if (agentB->currentBehavior == None) {
-            if (ofRandom(1) < 0.90) {
-              dataA->applyRepulsion = true;
-              e.a->GetBody()->SetUserData(dataA);
-            } else {
-              dataB->applyAttraction = true;
-              e.b->GetBody()->SetUserData(dataB);
-            }
-          }
-
-          // If agents can bond, evaluate the colliding bodies for collision.
-          // Along with the agents they both belong to.
-          if (shouldBond) {
-            evaluateBonding(e.a->GetBody(), e.b->GetBody(), agentA, agentB);
-          }
-        }
-      }
-    }
-  }
-}
-
-// ------------------------------ Inter-Agent Bonding Routines ------------------------------------ //
-
-// Critical routine that evaluates when the 2 bodies should actually bond to each other.
-void ofApp::evaluateBonding(b2Body *bodyA, b2Body *bodyB, Agent *agentA, Agent *agentB) {
-  collidingBodies.clear();
+  // Instrument patching
+  osc_attack >> agent->instrument.in_attack();
+  osc_decay >> agent->instrument.in_decay();
+  osc_release >> agent->instrument.in_release();
+  osc_sustain >> agent->instrument.in_sustain();
+  osc_velocity >> agent->instrument.in_velocity();
   
-  if (agentA->stretchCounter<100 && agentB->stretchCounter<100) {
-    // Vertex level checks. Is this vertex bonded to anything except itself?
-    bool a = canVertexBond(bodyA, agentA);
-    bool b = canVertexBond(bodyB, agentB);
-    if (a && b) {
-      // Prepare for bond.
-      collidingBodies.push_back(bodyA);
-      collidingBodies.push_back(bodyB);
-    }
-  }
-}
-
-bool ofApp::canVertexBond(b2Body* body, Agent *curAgent) {
-  // Does it have an interAgent joint already? If it doesn, can't allow this body to create another joint.
-  auto data = reinterpret_cast<VertexData*>(body->GetUserData());
-  return !data->hasInterAgentJoint;
-}
-
-void ofApp::createSuperAgents() {
-  // Joint creation based on when two bodies collide at certain vertices.
-  if (collidingBodies.size()>0) {
-      // Find the agent of this body.
-        auto bodyA = reinterpret_cast<VertexData*>(collidingBodies[0]);
-        auto bodyB = reinterpret_cast<VertexData*>(collidingBodies[1]);
-        
-        if (bodyA && bodyB) {
-          auto agentA = reinterpret_cast<VertexData*>(collidingBodies[0]->GetUserData())->agent;
-          auto agentB = reinterpret_cast<VertexData*>(collidingBodies[1]->GetUserData())->agent;
-        
-          // If both the agents have that state, then they'll bond.
-          SuperAgent superAgent; bool found = false;
-          std::shared_ptr<ofxBox2dJoint> j;
-          // Check for existing joints.
-          for (auto &sa : superAgents) {
-            // Is there a SuperAgent that already exists?
-            if (sa.contains(agentA, agentB)) {
-              j = createInterAgentJoint(collidingBodies[0], collidingBodies[1]);
-              sa.joints.push_back(j);
-              found = true;
-            }
-          }
-        
-          // Create a new Super Agent.
-          if (!found) {
-            j = createInterAgentJoint(collidingBodies[0], collidingBodies[1]);
-            superAgent.setup(agentA, agentB, j); // Create a new super agent.
-            superAgents.push_back(superAgent);
-          }
-      }
-    
-      collidingBodies.clear();
-  }
+  // Signal -> Filter -> Gain
+  agent->instrument.out_signal() >> filter.ch(i) >> gain.ch(i);
+  
+  // Feed it to the engine vi
+  gain.ch(i) >> compressor.ch(0) >> engine.audio_out(0);
+  gain.ch(i) >> compressor.ch(1) >> engine.audio_out(1);
 }
 
-std::shared_ptr<ofxBox2dJoint> ofApp::createInterAgentJoint(b2Body *bodyA, b2Body *bodyB) {
-    auto j = std::make_shared<ofxBox2dJoint>();
-    j->setup(box2d.getWorld(), bodyA, bodyB, iJointFrequency, iJointDamping); // Use the interAgentJoint props.
-  
-    // Joint length (determine with probability)
-    int jointLength = ofRandom(iMinJointLength, iMaxJointLength);
-    j->setLength(jointLength);
-  
-    // Update Body A
-    auto data = reinterpret_cast<VertexData*>(bodyA->GetUserData());
-    data->hasInterAgentJoint = true;
-    data->jointMeshIdx = SuperAgent::curMeshIdx;
-    bodyA->SetUserData(data);
-  
-    // Update Body B
-    data = reinterpret_cast<VertexData*>(bodyB->GetUserData());
-    data->hasInterAgentJoint = true;
-    data->jointMeshIdx = SuperAgent::curMeshIdx + 1;
-    bodyB->SetUserData(data);
-  
-    // Insert these into mesh for the interAgent joints.
-    auto posA = getBodyPosition(bodyA); auto posB = getBodyPosition(bodyB);
-    SuperAgent::insertJointMesh(glm::vec3(posA.x, posA.y, 0), glm::vec3(posB.x, posB.y, 0));
-  
-    // Increment by 2 because it just served 2 bodies.
-    SuperAgent::curMeshIdx += 2;
-  
-    return j;
+void ofApp::onAgentExploded(NestAgentEventArgs &args) {
+  // Play the pop sound for the agent.
+  popPlayer.play();
 }
 
 void ofApp::updateMaskFbo(ofImage img) {
@@ -980,6 +593,10 @@ void ofApp::onMaskImgUpdate(int &newVal) {
   cout << "New Mask Image set: " << newVal - 1 << endl;
 }
 
+void ofApp::onSimulationThreadUpdate(bool &newVal) {
+  nestThread.setThreaded(newVal);
+}
+
 void ofApp::onDeviceIdUpdate(int &newVal) {
   cout << "New Device Id set: " << newVal << endl;
   engine.setDeviceID(newVal);
@@ -10,6 +10,9 @@
 #include "BgMesh.h"
 #include "Kinect.h"
 #include "Memory.h"
+#include "Nest.h"
+#include "NestThread.h"
+#include "NestRenderer.h"
 #include "SuperAgent.h"
 
 #define PORT 8000
@@ -23,6 +26,8 @@ class ofApp : public ofBaseApp{
 		void draw();
     void keyPressed(int key);
     void mousePressed(int x, int y, int button);
+    void mouseDragged(int x, int y, int button);
+    void mouseReleased(int x, int y, int button);
     void exit();
   
     // Public helpers.
@@ -32,17 +37,14 @@ class ofApp : public ofBaseApp{
     void updateAgentProps();
     void handleInteraction(); 
   
-    // Behavior methods.
-    void setBehavior(std::vector<glm::vec2> people);
-    void clearInterAgentBonds(); 
-  
-    // Contact listening callbacks.
-    void contactStart(ofxBox2dContactArgs &e);
-    void contactEnd(ofxBox2dContactArgs &e);
+    // Nest callbacks.
+    void onAgentCreated(NestAgentEventArgs &args);
+    void onAgentExploded(NestAgentEventArgs &args);
   
     // GUI Callbacks
     void onDeviceIdUpdate(int &newVal);
     void onMaskImgUpdate(int &newVal);
+    void onSimulationThreadUpdate(bool &newVal);
   
   
     // Flags to turn/turn off certain features
@@ -52,20 +54,20 @@ class ofApp : public ofBaseApp{
     bool stopEverything;
     bool showTexture;
     bool drawFbo; // For saving frames.
-    bool shouldBond;
     bool showVisibilityRadius;
     bool showFrameRate;
-    bool resetMesh;
     bool showMask; 
 
-    // Box2d world handle.
-    ofxBox2d box2d;
-  
-    // Agents
-    std::vector<Agent *> agents;
-    // GUI parameters for Alpha/Beta agents. 
+    // Simulation core (Box2d world, agents, bonds, memories). Once it's set up, only
+    // nestThread touches it. We draw its snapshots.
+    Nest nest;
+    NestThread nestThread;
+    NestRenderer renderer;
+    FrameProfiler renderProfiler;
+    std::deque<float> frameTimes; // Last few frame times (ms) for the jitter.
     AlphaAgentProperties alphaAgentProps;
     BetaAgentProperties betaAgentProps;
+    NestProperties nestProps;
   
     // Screengrab fbo
     ofFbo screenGrabFbo;
@@ -83,6 +85,10 @@ class ofApp : public ofBaseApp{
     ofParameter<int> maxAgentsInWorld;
     ofParameter<int> reincarnationWaitTime;
     ofParameter<int> maskImage; 
+    ofParameter<float> physicsHz;
+    ofParameter<int> maxPhysicsSteps;
+    ofParameter<int> behaviorThreads;
+    ofParameter<bool> simulationThread;
   
     // Alpha Agent Group params. 
     ofParameterGroup alphaAgentParams;
@@ -160,36 +166,12 @@ class ofApp : public ofBaseApp{
     // Helper methods.
     void clearScreen();
     void removeJoints();
-    void removeUnbonded();
-    void drawSequence();
-    glm::vec2 getBodyPosition(b2Body* body);
+    void drawSequence(const NestSnapshot &snapshot);
+    std::string getFrameStats(const NestSnapshot &snapshot);
     void createWorld(bool createBonds);
-    Agent *getClosestAgent(std::vector<Agent *> targetAgents, glm::vec2 targetPos);
-    std::vector<Agent *> getVisibleAgents(glm::vec2 person);
-    std::vector<Agent *> getInvisibleAgents(glm::vec2 person);
-    std::vector<glm::vec2> getInvisibleTargets(std::vector<glm::vec2> targets, Agent* a);
-    void wasteTime();
-    void enableRepelBeforeBreak();
     void evaluateEntryExit(int peopleNum);
     void updateMaskFbo(ofImage maskImage);
   
-    int specialRepelTimer; // Keeps track of the repelling.
-    std::vector<Memory> brokenBonds;
-    std::vector<Memory> explodedAgent; 
-    std::vector<b2Body *> collidingBodies;
-  
-    // Super Agents (Inter Agent Bonding Logic)
-    void createSuperAgents();
-    std::shared_ptr<ofxBox2dJoint> createInterAgentJoint(b2Body *bodyA, b2Body *bodyB);
-    void evaluateBonding(b2Body* bodyA, b2Body* bodyB, Agent *agentA, Agent *agentB);
-    bool canVertexBond(b2Body* body, Agent *curAgent);
-  
-    // SuperAgents => These are abstract agents that have a bond with each other. 
-    std::vector<SuperAgent> superAgents;
-  
-    // Bounds
-    ofRectangle bounds;
-  
     // Background
     BgMesh bg;
   
@@ -200,13 +182,8 @@ class ofApp : public ofBaseApp{
     Kinect kinect;
   
     // Occupied
-    bool isOccupied;
     int prevPeopleSize;
   
-    // Pending time to track agents killed.
-    int pendingAgentsNum;
-    long pendingAgentTime; 
-  
     std::vector<glm::vec2> testPeople;
   
     // Sound player to play the pop
@@ -221,7 +198,4 @@ class ofApp : public ofBaseApp{
     ofFbo masterFbo;
     ofFbo maskFbo;
     std::vector<ofImage> maskImages;
-  
-    // Agent idx
-    int agentIdx;
 };